@@ -0,0 +1,119 @@
+﻿#pragma once
+#include <vector>
+#include <string_view>
+#include <variant>
+#include <cstdint>
+#include "VecKernels.h"
+
+// Alpha 指令集：必须保证 CrackMe 和 Solver 完全一致
+namespace Alpha {
+    struct OpLoadImm { int reg_idx; int64_t value; };
+    struct OpLoadInput { int reg_idx; int input_idx; }; // 从用户输入读取一个字符到寄存器
+    struct OpAdd { int dest; int src; };
+    struct OpXor { int dest; int src; };
+    struct OpMul { int dest; int src; };
+    struct OpCheck { int reg_idx; int64_t expected; }; // 检查点
+    struct OpTrap {}; // 隐蔽的陷阱指令
+
+    // 向量指令：一次处理 kVecWidth 个输入字节，每个字节独立做 mod 256 运算
+    // 32 字节的立即数放在 Bytecode::pool 里，指令只存下标，不把每条指令都撑大
+    struct OpVecLoad { int vreg; int input_idx; };                 // V[vreg] = Input[idx .. idx+32)
+    struct OpVecAdd { int vreg; uint32_t imm; };
+    struct OpVecXor { int vreg; uint32_t imm; };
+    struct OpVecMul { int vreg; uint32_t imm; };
+    // 比较前 lanes 个字节；accumulate 为 true 时与上一次检查结果相与，便于多段长 Key 校验
+    struct OpVecCheck { int vreg; int lanes; bool accumulate; uint32_t expected; };
+
+    constexpr int kVecRegs = 4;
+
+    // 所有指令的集合
+    using Instruction = std::variant<OpLoadImm, OpLoadInput, OpAdd, OpXor, OpMul, OpCheck, OpTrap,
+        OpVecLoad, OpVecAdd, OpVecXor, OpVecMul, OpVecCheck>;
+
+    static_assert(sizeof(Instruction) <= 24, "vector immediates belong in Bytecode::pool");
+
+    // 字节码 + 向量立即数池，两者一起交给 VM / Session / Solver
+    struct Bytecode {
+        std::vector<Instruction> code;
+        std::vector<VecBytes> pool;
+
+        uint32_t intern(const VecBytes& v) {
+            pool.push_back(v);
+            return static_cast<uint32_t>(pool.size() - 1);
+        }
+    };
+
+    // 这里构建逻辑：(Input[0] + 10) ^ 0xDEADBEEF == ...
+    // 但我们用一大堆指令来实现它
+    inline Bytecode build_program() {
+        Bytecode program;
+        auto& bytecode = program.code;
+
+        // 这里的逻辑对应：检查 Input[0] 是否等于 'A' (65)
+        // 实际上：((Input[0] * 2) ^ 123) == (65 * 2) ^ 123
+
+        bytecode.push_back(OpLoadInput{ 0, 0 }); // R0 = Input[0]
+        bytecode.push_back(OpLoadImm{ 1, 2 });   // R1 = 2
+        bytecode.push_back(OpMul{ 0, 1 });       // R0 = R0 * R1
+        bytecode.push_back(OpLoadImm{ 2, 123 }); // R2 = 123
+        bytecode.push_back(OpXor{ 0, 2 });       // R0 = R0 ^ R2
+
+        // 计算目标值: 'A'(65) * 2 = 130; 130 ^ 123 = 249
+        bytecode.push_back(OpCheck{ 0, 249 });
+
+        return program;
+    }
+
+    // 长 Key 校验：对每个字节做 ((c ^ kx) + ka) * km，再和给定 Key 算出的期望值比较
+    // vectorized=false 时只用标量指令，把每个字节折叠进 R7 累加器，最后一条 OpCheck
+    // vectorized=true 时每 32 字节一组，用 accumulate 的 OpVecCheck 串起来
+    inline Bytecode build_long_program(std::string_view key, bool vectorized) {
+        auto kx = [](size_t i) { return static_cast<uint8_t>(i * 0x9D + 0x5A); };
+        auto ka = [](size_t i) { return static_cast<uint8_t>(i * 0x3B + 0x11); };
+        auto km = [](size_t i) { return static_cast<uint8_t>((i * 0x26 + 0x4B) | 1); };
+
+        Bytecode program;
+        auto& code = program.code;
+
+        if (!vectorized) {
+            constexpr uint64_t prime = 0x100000001B3;
+            uint64_t acc = 0;
+            code.push_back(OpLoadImm{ 7, 0 });
+            code.push_back(OpLoadImm{ 6, (int64_t)prime });
+            for (size_t i = 0; i < key.size(); ++i) {
+                code.push_back(OpLoadInput{ 0, (int)i });
+                code.push_back(OpLoadImm{ 1, kx(i) });
+                code.push_back(OpXor{ 0, 1 });
+                code.push_back(OpLoadImm{ 1, ka(i) });
+                code.push_back(OpAdd{ 0, 1 });
+                code.push_back(OpLoadImm{ 1, km(i) });
+                code.push_back(OpMul{ 0, 1 });
+                code.push_back(OpMul{ 7, 6 });
+                code.push_back(OpAdd{ 7, 0 });
+
+                uint64_t v = (((uint8_t)key[i] ^ kx(i)) + ka(i)) * (uint64_t)km(i);
+                acc = acc * prime + v;
+            }
+            code.push_back(OpCheck{ 7, (int64_t)acc });
+            return program;
+        }
+
+        for (size_t base = 0, v = 0; base < key.size(); base += kVecWidth, v = (v + 1) % kVecRegs) {
+            VecBytes x{}, a{}, m{}, expected{};
+            size_t lanes = key.size() - base < kVecWidth ? key.size() - base : kVecWidth;
+            for (size_t l = 0; l < kVecWidth; ++l) {
+                x[l] = kx(base + l);
+                a[l] = ka(base + l);
+                m[l] = km(base + l);
+                uint8_t c = l < lanes ? (uint8_t)key[base + l] : 0;
+                expected[l] = static_cast<uint8_t>(((c ^ x[l]) + a[l]) * m[l]);
+            }
+            code.push_back(OpVecLoad{ (int)v, (int)base });
+            code.push_back(OpVecXor{ (int)v, program.intern(x) });
+            code.push_back(OpVecAdd{ (int)v, program.intern(a) });
+            code.push_back(OpVecMul{ (int)v, program.intern(m) });
+            code.push_back(OpVecCheck{ (int)v, (int)lanes, base != 0, program.intern(expected) });
+        }
+        return program;
+    }
+}
@@ -0,0 +1,221 @@
+﻿#pragma once
+#include <array>
+#include <vector>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include "VirtualMachine.h"
+
+// ==========================================
+// 紧凑会话：大量常驻会话时替代 VirtualMachine + VmTask
+// 没有协程帧、没有 std::string / std::vector，字节码由所有会话共享
+// ==========================================
+namespace Alpha {
+
+    constexpr size_t kCacheLine = 64;
+
+    // 4 条缓存行：标量寄存器 | 向量寄存器 x2 | 元数据 + 内联 Key
+    struct alignas(kCacheLine) Session {
+        std::array<int64_t, 8> regs;
+        std::array<VecReg, kVecRegs> vregs;
+
+        const Instruction* code;   // 共享字节码，生命周期由调用方保证
+        const VecBytes* pool;      // 字节码的向量立即数池
+        int64_t last_step;         // 上一条指令的时刻，0 表示停放中，下一次 step() 重新对时
+        uint32_t code_len;
+        uint32_t pc;
+        uint16_t key_len;
+        uint8_t flag_zero : 1;
+        uint8_t is_trapped : 1;
+
+        // Key 不超过 kInlineKey 时直接存这里，否则这里存一个指向 arena 的指针
+        static constexpr size_t kInlineKey = kCacheLine - 2 * sizeof(void*) - sizeof(int64_t) - 2 * sizeof(uint32_t) - sizeof(uint16_t) - 1;
+        static constexpr size_t kMaxKey = UINT16_MAX;
+        char key_inline[kInlineKey];
+
+        std::string_view input() const {
+            if (key_len <= kInlineKey) return { key_inline, key_len };
+            const char* p;
+            std::memcpy(&p, key_inline, sizeof(p));
+            return { p, key_len };
+        }
+
+        bool done() const { return pc >= code_len; }
+        bool is_success() const { return flag_zero && !is_trapped; }
+    };
+
+    static_assert(sizeof(Session) == 4 * kCacheLine, "Session must stay four cache lines");
+
+    // ==========================================
+    // 每线程的 bump 分配器
+    // 会话只能在创建它的线程上销毁
+    // 长 Key 的副本按 2 的幂分级，destroy() 时放回对应级别的空闲链表
+    // Key 最长 65535 字节，更长的 create() 直接返回 nullptr
+    // ==========================================
+    class SessionArena {
+        static constexpr size_t kBlockSize = 1 << 20;
+        static constexpr size_t kMinKeyClass = 6;  // 64 字节
+        static constexpr size_t kKeyClasses = 17 - kMinKeyClass; // 最大 64 KiB，放得下 kMaxKey
+
+        std::vector<std::byte*> blocks;
+        std::byte* cur = nullptr;
+        std::byte* end = nullptr;
+        Session* free_list = nullptr;
+        std::array<void*, kKeyClasses> key_free{};
+        size_t live = 0;
+
+        static size_t key_class(size_t len) {
+            size_t c = 0;
+            while ((size_t{ 1 } << (c + kMinKeyClass)) < len) ++c;
+            return c;
+        }
+
+        // 空闲链表的 next 指针就存在空闲块的开头
+        static void* pop(void*& head) {
+            void* p = head;
+            if (p) std::memcpy(&head, p, sizeof(head));
+            return p;
+        }
+
+        static void push(void*& head, void* p) {
+            std::memcpy(p, &head, sizeof(head));
+            head = p;
+        }
+
+        void* bump(size_t size, size_t align) {
+            auto p = reinterpret_cast<uintptr_t>(cur);
+            p = (p + align - 1) & ~(uintptr_t)(align - 1);
+            if (!cur || p + size > reinterpret_cast<uintptr_t>(end)) {
+                cur = static_cast<std::byte*>(::operator new(kBlockSize, std::align_val_t{ kCacheLine }));
+                end = cur + kBlockSize;
+                blocks.push_back(cur);
+                p = reinterpret_cast<uintptr_t>(cur);
+            }
+            cur = reinterpret_cast<std::byte*>(p + size);
+            return reinterpret_cast<void*>(p);
+        }
+
+    public:
+        SessionArena() = default;
+        SessionArena(const SessionArena&) = delete;
+        SessionArena& operator=(const SessionArena&) = delete;
+        ~SessionArena() { release(); }
+
+        Session* create(std::string_view key, const Bytecode& program) {
+            if (key.size() > Session::kMaxKey) return nullptr;
+
+            void* mem;
+            if (free_list) {
+                mem = free_list;
+                std::memcpy(&free_list, free_list, sizeof(free_list));
+            }
+            else {
+                mem = bump(sizeof(Session), alignof(Session));
+            }
+
+            auto* s = new (mem) Session{};
+            s->code = program.code.data();
+            s->pool = program.pool.data();
+            s->code_len = static_cast<uint32_t>(program.code.size());
+            s->key_len = static_cast<uint16_t>(key.size());
+            if (s->key_len <= Session::kInlineKey) {
+                std::memcpy(s->key_inline, key.data(), s->key_len);
+            }
+            else {
+                size_t c = key_class(s->key_len);
+                void* block = pop(key_free[c]);
+                if (!block) block = bump(size_t{ 1 } << (c + kMinKeyClass), alignof(void*));
+                auto* copy = static_cast<char*>(block);
+                std::memcpy(copy, key.data(), s->key_len);
+                std::memcpy(s->key_inline, &copy, sizeof(copy));
+            }
+            ++live;
+            return s;
+        }
+
+        void destroy(Session* s) {
+            if (s->key_len > Session::kInlineKey) {
+                char* copy;
+                std::memcpy(&copy, s->key_inline, sizeof(copy));
+                push(key_free[key_class(s->key_len)], copy);
+            }
+            std::memcpy(static_cast<void*>(s), &free_list, sizeof(free_list));
+            free_list = s;
+            --live;
+        }
+
+        // 一次性丢弃所有会话，保留第一块内存复用
+        void reset() {
+            for (size_t i = 1; i < blocks.size(); ++i) ::operator delete(blocks[i], std::align_val_t{ kCacheLine });
+            if (!blocks.empty()) blocks.resize(1);
+            cur = blocks.empty() ? nullptr : blocks[0];
+            end = cur ? cur + kBlockSize : nullptr;
+            free_list = nullptr;
+            key_free = {};
+            live = 0;
+        }
+
+        void release() {
+            for (auto* b : blocks) ::operator delete(b, std::align_val_t{ kCacheLine });
+            blocks.clear();
+            cur = end = nullptr;
+            free_list = nullptr;
+            key_free = {};
+            live = 0;
+        }
+
+        size_t live_sessions() const { return live; }
+        size_t reserved_bytes() const { return blocks.size() * kBlockSize; }
+    };
+
+    inline SessionArena& local_arena() {
+        thread_local SessionArena arena;
+        return arena;
+    }
+
+    // ==========================================
+    // 会话驱动：一次最多执行 budget 条指令，返回是否执行完毕
+    // 骨架和 VirtualMachine 相同，只是不开协程：时钟检测的上一时刻存在 last_step 里，
+    // 跨调用也连续，两次 step() 之间的停顿同样计入；budget 用完就返回
+    // 只有调度器显式 resume() 停放过的会话才重新对时
+    // ==========================================
+    using SessionCore = VmCore::Core<VmCore::Visit, VmCore::InlineClockAt<kStepLimitMs>, VmCore::Values, VmCore::Budget>;
+
+    // 骨架回调，input() 每次 step() 只解一次
+    struct SessionMachine {
+        Session& s;
+        std::string_view input;
+
+        bool done(size_t pc) const { return pc >= s.code_len; }
+        const Instruction& fetch(size_t pc) const { return s.code[pc]; }
+
+        template <typename T>
+        VmCore::Next operator()(const T& op, size_t) {
+            apply(s, input, s.pool, op);
+            return VmCore::kNext;
+        }
+
+        void tamper() { s.is_trapped = true; }
+        void finish() {}
+    };
+
+    // 调度器把会话从停放状态取回时调用，停放期间的间隔不算单步调试
+    inline void resume(Session& s) {
+        s.last_step = 0;
+    }
+
+    inline bool step(Session& s, size_t budget) {
+        if (budget == 0) return s.done();
+
+        SessionMachine m{ s, s.input() };
+        VmCore::InlineClockAt<kStepLimitMs> guard{ s.last_step };
+        VmCore::Budget sched{ budget };
+        size_t pc = s.pc;
+
+        SessionCore::slice(m, guard, sched, pc);
+        s.pc = static_cast<uint32_t>(pc);
+        return s.done();
+    }
+}
@@ -0,0 +1,116 @@
+﻿#pragma once
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ALPHA_VEC_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ALPHA_VEC_SSE2 1
+#endif
+
+// ==========================================
+// 向量寄存器与 SIMD 内核
+// 每条向量指令一次处理 32 个输入字节，按字节 (mod 256) 运算
+// ==========================================
+namespace Alpha {
+    constexpr size_t kVecWidth = 32;
+
+    using VecBytes = std::array<uint8_t, kVecWidth>;
+
+    struct alignas(32) VecReg {
+        VecBytes b{};
+    };
+
+    namespace Kernel {
+        // 从输入加载 lanes 个字节，越界部分补 0（与 OpLoadInput 的越界行为一致）
+        inline void load(VecReg& dst, const char* src, size_t src_len, size_t offset) {
+            dst.b.fill(0);
+            if (offset < src_len) {
+                size_t n = src_len - offset < kVecWidth ? src_len - offset : kVecWidth;
+                std::memcpy(dst.b.data(), src + offset, n);
+            }
+        }
+
+#if defined(ALPHA_VEC_AVX2)
+        inline void add(VecReg& d, const VecBytes& k) {
+            __m256i a = _mm256_load_si256((const __m256i*)d.b.data());
+            __m256i b = _mm256_loadu_si256((const __m256i*)k.data());
+            _mm256_store_si256((__m256i*)d.b.data(), _mm256_add_epi8(a, b));
+        }
+
+        inline void xor_(VecReg& d, const VecBytes& k) {
+            __m256i a = _mm256_load_si256((const __m256i*)d.b.data());
+            __m256i b = _mm256_loadu_si256((const __m256i*)k.data());
+            _mm256_store_si256((__m256i*)d.b.data(), _mm256_xor_si256(a, b));
+        }
+
+        // 没有 8 位乘法指令：奇偶字节分别用 16 位乘法，再拼回去
+        inline void mul(VecReg& d, const VecBytes& k) {
+            __m256i a = _mm256_load_si256((const __m256i*)d.b.data());
+            __m256i b = _mm256_loadu_si256((const __m256i*)k.data());
+            __m256i even = _mm256_mullo_epi16(a, b);
+            __m256i odd = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+            __m256i lo = _mm256_and_si256(even, _mm256_set1_epi16(0x00FF));
+            _mm256_store_si256((__m256i*)d.b.data(), _mm256_or_si256(lo, _mm256_slli_epi16(odd, 8)));
+        }
+
+        inline bool equal(const VecReg& d, const VecBytes& k, size_t lanes) {
+            __m256i a = _mm256_load_si256((const __m256i*)d.b.data());
+            __m256i b = _mm256_loadu_si256((const __m256i*)k.data());
+            uint32_t m = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+            uint32_t want = lanes >= 32 ? 0xFFFFFFFFu : (1u << lanes) - 1;
+            return (m & want) == want;
+        }
+#elif defined(ALPHA_VEC_SSE2)
+        inline void add(VecReg& d, const VecBytes& k) {
+            for (size_t i = 0; i < kVecWidth; i += 16) {
+                __m128i a = _mm_load_si128((const __m128i*)(d.b.data() + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(k.data() + i));
+                _mm_store_si128((__m128i*)(d.b.data() + i), _mm_add_epi8(a, b));
+            }
+        }
+
+        inline void xor_(VecReg& d, const VecBytes& k) {
+            for (size_t i = 0; i < kVecWidth; i += 16) {
+                __m128i a = _mm_load_si128((const __m128i*)(d.b.data() + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(k.data() + i));
+                _mm_store_si128((__m128i*)(d.b.data() + i), _mm_xor_si128(a, b));
+            }
+        }
+
+        inline void mul(VecReg& d, const VecBytes& k) {
+            for (size_t i = 0; i < kVecWidth; i += 16) {
+                __m128i a = _mm_load_si128((const __m128i*)(d.b.data() + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(k.data() + i));
+                __m128i even = _mm_mullo_epi16(a, b);
+                __m128i odd = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+                __m128i lo = _mm_and_si128(even, _mm_set1_epi16(0x00FF));
+                _mm_store_si128((__m128i*)(d.b.data() + i), _mm_or_si128(lo, _mm_slli_epi16(odd, 8)));
+            }
+        }
+
+        inline bool equal(const VecReg& d, const VecBytes& k, size_t lanes) {
+            uint32_t m = 0;
+            for (size_t i = 0; i < kVecWidth; i += 16) {
+                __m128i a = _mm_load_si128((const __m128i*)(d.b.data() + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(k.data() + i));
+                m |= (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) << i;
+            }
+            uint32_t want = lanes >= 32 ? 0xFFFFFFFFu : (1u << lanes) - 1;
+            return (m & want) == want;
+        }
+#else
+        inline void add(VecReg& d, const VecBytes& k) { for (size_t i = 0; i < kVecWidth; ++i) d.b[i] += k[i]; }
+        inline void xor_(VecReg& d, const VecBytes& k) { for (size_t i = 0; i < kVecWidth; ++i) d.b[i] ^= k[i]; }
+        inline void mul(VecReg& d, const VecBytes& k) { for (size_t i = 0; i < kVecWidth; ++i) d.b[i] *= k[i]; }
+        inline bool equal(const VecReg& d, const VecBytes& k, size_t lanes) {
+            for (size_t i = 0; i < lanes && i < kVecWidth; ++i) if (d.b[i] != k[i]) return false;
+            return true;
+        }
+#endif
+    }
+}
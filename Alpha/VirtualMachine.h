@@ -0,0 +1,139 @@
+﻿#pragma once
+#include <vector>
+#include <array>
+#include <string>
+#include <string_view>
+#include <variant>
+#include "Common.h"
+#include "../Shared/VmCore.h"
+
+namespace Alpha {
+
+    // ==========================================
+    // 1. 虚拟寄存器状态
+    // 指令集本身见 Common.h
+    // ==========================================
+
+    struct VmContext {
+        std::array<int64_t, 8> regs = { 0 }; // R0-R7
+        std::array<VecReg, kVecRegs> vregs{}; // V0-V3，每个 32 字节
+        std::vector<int64_t> stack;
+        bool flag_zero = false;
+        bool is_trapped = false; // 反调试触发标志
+
+        // 简单的输入缓冲区映射
+        std::string user_input;
+    };
+
+    // ==========================================
+    // 2. 指令语义
+    // 协程 VM 和紧凑会话 (Session.h) 共用同一份实现
+    // pool 是字节码的向量立即数池，向量指令按下标取
+    // ==========================================
+
+    template <typename Ctx, typename T>
+    inline void apply(Ctx& ctx, std::string_view input, const VecBytes* pool, const T& arg) {
+        // 如果触发了陷阱，所有计算结果悄悄变异
+        int64_t mutation = ctx.is_trapped ? 0x1337 : 0;
+
+        if constexpr (std::is_same_v<T, OpLoadImm>) {
+            ctx.regs[arg.reg_idx] = arg.value + mutation;
+        }
+        else if constexpr (std::is_same_v<T, OpLoadInput>) {
+            if (arg.input_idx < input.size())
+                ctx.regs[arg.reg_idx] = (unsigned char)input[arg.input_idx];
+            else
+                ctx.regs[arg.reg_idx] = 0;
+        }
+        else if constexpr (std::is_same_v<T, OpAdd>) {
+            ctx.regs[arg.dest] += ctx.regs[arg.src] + mutation;
+        }
+        else if constexpr (std::is_same_v<T, OpXor>) {
+            ctx.regs[arg.dest] ^= ctx.regs[arg.src];
+        }
+        else if constexpr (std::is_same_v<T, OpMul>) {
+            ctx.regs[arg.dest] *= ctx.regs[arg.src];
+        }
+        else if constexpr (std::is_same_v<T, OpCheck>) {
+            // 这是校验点
+            if (ctx.regs[arg.reg_idx] != arg.expected) {
+                ctx.flag_zero = false;
+            }
+            else {
+                ctx.flag_zero = true;
+            }
+        }
+        else if constexpr (std::is_same_v<T, OpVecLoad>) {
+            Kernel::load(ctx.vregs[arg.vreg], input.data(), input.size(), arg.input_idx);
+        }
+        else if constexpr (std::is_same_v<T, OpVecAdd>) {
+            Kernel::add(ctx.vregs[arg.vreg], pool[arg.imm]);
+            if (mutation) {
+                VecBytes noise;
+                noise.fill(static_cast<uint8_t>(mutation));
+                Kernel::add(ctx.vregs[arg.vreg], noise);
+            }
+        }
+        else if constexpr (std::is_same_v<T, OpVecXor>) {
+            Kernel::xor_(ctx.vregs[arg.vreg], pool[arg.imm]);
+        }
+        else if constexpr (std::is_same_v<T, OpVecMul>) {
+            Kernel::mul(ctx.vregs[arg.vreg], pool[arg.imm]);
+        }
+        else if constexpr (std::is_same_v<T, OpVecCheck>) {
+            bool eq = Kernel::equal(ctx.vregs[arg.vreg], pool[arg.expected], arg.lanes);
+            ctx.flag_zero = arg.accumulate ? (ctx.flag_zero && eq) : eq;
+        }
+    }
+
+    template <typename Ctx>
+    inline void execute(Ctx& ctx, std::string_view input, const VecBytes* pool, const Instruction& inst) {
+        // 利用 std::visit 混淆控制流
+        std::visit([&](const auto& arg) { apply(ctx, input, pool, arg); }, inst);
+    }
+
+    // ==========================================
+    // 3. 虚拟机核心
+    // 骨架见 Shared/VmCore.h：std::visit 分派、内联时钟检测、
+    // 没有跳转指令所以分支走返回值、每条指令挂起一次协程
+    // ==========================================
+
+    // 两条指令之间超过这个间隔就认为在单步调试，Session 的驱动也用它
+    constexpr int64_t kStepLimitMs = 100;
+
+    using VmTask = VmCore::Task;
+    using Core = VmCore::Core<VmCore::Visit, VmCore::InlineClock<kStepLimitMs>, VmCore::Values, VmCore::YieldEvery<1>>;
+
+    class VirtualMachine {
+        VmContext ctx;
+        Bytecode bytecode;
+
+    public:
+        VirtualMachine(const std::string& input) : VirtualMachine(input, build_program()) {}
+
+        VirtualMachine(const std::string& input, Bytecode code) : bytecode(std::move(code)) {
+            ctx.user_input = input;
+        }
+
+        // 协程运行器
+        VmTask run() { return Core::run(*this); }
+
+        bool is_success() const {
+            return ctx.flag_zero && !ctx.is_trapped;
+        }
+
+        // --- 骨架回调 ---
+        bool done(size_t pc) const { return pc >= bytecode.code.size(); }
+        const Instruction& fetch(size_t pc) const { return bytecode.code[pc]; }
+
+        template <typename T>
+        VmCore::Next operator()(const T& op, size_t) {
+            apply(ctx, ctx.user_input, bytecode.pool.data(), op);
+            return VmCore::kNext;
+        }
+
+        // 如果两条指令之间间隔超过 100ms，说明有人在单步调试
+        void tamper() { ctx.is_trapped = true; }
+        void finish() {}
+    };
+}
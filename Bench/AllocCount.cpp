@@ -0,0 +1,48 @@
+﻿#include <new>
+#include <cstdlib>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+#include "Bench.h"
+
+// 替换全局 operator new，统计基准测试期间的堆分配次数和字节数
+namespace AllocCount {
+    std::atomic<size_t> calls{ 0 };
+    std::atomic<size_t> bytes{ 0 };
+}
+
+namespace {
+    void* counted(size_t n, size_t align) {
+        AllocCount::calls.fetch_add(1, std::memory_order_relaxed);
+        AllocCount::bytes.fetch_add(n, std::memory_order_relaxed);
+        if (n == 0) n = 1;
+#if defined(_MSC_VER)
+        void* p = _aligned_malloc(n, align);
+#else
+        void* p = std::aligned_alloc(align, (n + align - 1) / align * align);
+#endif
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+
+    void release(void* p) noexcept {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+void* operator new(size_t n) { return counted(n, alignof(std::max_align_t)); }
+void* operator new[](size_t n) { return counted(n, alignof(std::max_align_t)); }
+void* operator new(size_t n, std::align_val_t a) { return counted(n, (size_t)a); }
+void* operator new[](size_t n, std::align_val_t a) { return counted(n, (size_t)a); }
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { release(p); }
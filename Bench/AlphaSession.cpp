@@ -0,0 +1,125 @@
+﻿#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include "Bench.h"
+#include "../Alpha/Session.h"
+
+// 10^6 个常驻会话：VirtualMachine + 协程帧 vs 紧凑 Session + 每线程 arena
+namespace {
+    constexpr size_t kSessions = 1'000'000;
+
+    struct Legacy {
+        Alpha::VirtualMachine vm;
+        Alpha::VmTask task;
+        explicit Legacy(const std::string& key) : vm(key), task(vm.run()) {}
+    };
+
+    struct Sample {
+        double ns_per_session;
+        double bytes_per_session;
+        double allocs_per_session;
+    };
+
+    template <typename F>
+    Sample measure(F&& create) {
+        size_t calls0 = AllocCount::calls.load();
+        size_t bytes0 = AllocCount::bytes.load();
+        auto t0 = std::chrono::steady_clock::now();
+        size_t extra = create();
+        auto t1 = std::chrono::steady_clock::now();
+        size_t calls = AllocCount::calls.load() - calls0;
+        size_t bytes = AllocCount::bytes.load() - bytes0 + extra;
+        return {
+            std::chrono::duration<double, std::nano>(t1 - t0).count() / kSessions,
+            (double)bytes / kSessions,
+            (double)calls / kSessions,
+        };
+    }
+}
+
+int bench_alpha_session() {
+    const std::string key = "A";
+
+    std::vector<std::unique_ptr<Legacy>> legacy;
+    legacy.reserve(kSessions);
+    Sample old = measure([&] {
+        for (size_t i = 0; i < kSessions; ++i) legacy.push_back(std::make_unique<Legacy>(key));
+        return size_t{ 0 };
+    });
+    // 逐个跑完，确认结果正确
+    size_t old_ok = 0;
+    for (auto& l : legacy) {
+        while (!l->task.done()) l->task.resume();
+        old_ok += l->vm.is_success();
+    }
+    legacy.clear();
+    legacy.shrink_to_fit();
+
+    const auto code = Alpha::build_program();
+    auto& arena = Alpha::local_arena();
+    std::vector<Alpha::Session*> sessions;
+    sessions.reserve(kSessions);
+    Sample fresh = measure([&] {
+        for (size_t i = 0; i < kSessions; ++i) sessions.push_back(arena.create(key, code));
+        // arena 的块分配已经被计数，这里不再额外加
+        return size_t{ 0 };
+    });
+    size_t new_ok = 0;
+    for (auto* s : sessions) {
+        Alpha::step(*s, SIZE_MAX);
+        new_ok += s->is_success();
+    }
+
+    // 回收后再创建：走空闲链表，不再触碰全局堆
+    for (auto* s : sessions) arena.destroy(s);
+    sessions.clear();
+    Sample reuse = measure([&] {
+        for (size_t i = 0; i < kSessions; ++i) sessions.push_back(arena.create(key, code));
+        return size_t{ 0 };
+    });
+    arena.release();
+
+    // 长 Key（不能内联）反复创建销毁：没有常驻会话时 arena 占用不能增长
+    const std::string long_key(64, 'A');
+    std::vector<size_t> reserved;
+    for (int round = 0; round < 5; ++round) {
+        for (size_t i = 0; i < 100'000; ++i) sessions[i] = arena.create(long_key, code);
+        for (size_t i = 0; i < 100'000; ++i) arena.destroy(sessions[i]);
+        reserved.push_back(arena.reserved_bytes());
+    }
+    bool churn_flat = reserved.front() == reserved.back();
+    bool too_long_rejected = arena.create(std::string(Alpha::Session::kMaxKey + 1, 'A'), code) == nullptr;
+    arena.release();
+
+    // 逐条时间检测跨越 step() 调用：两次调用之间停顿超过 100ms 也算单步调试，resume() 之后不算
+    auto* paused = arena.create(key, code);
+    Alpha::step(*paused, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    Alpha::step(*paused, 1);
+    auto* parked = arena.create(key, code);
+    Alpha::step(*parked, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    Alpha::resume(*parked);
+    Alpha::step(*parked, 1);
+    bool paused_trapped = paused->is_trapped, parked_trapped = parked->is_trapped;
+    bool clock_ok = paused_trapped && !parked_trapped;
+    arena.release();
+
+    std::printf("  sessions: %zu, sizeof(VirtualMachine) %zu, sizeof(Session) %zu\n",
+        kSessions, sizeof(Alpha::VirtualMachine), sizeof(Alpha::Session));
+    std::printf("  VirtualMachine+VmTask: %7.1f ns/session %7.1f bytes/session %5.2f allocs/session (ok %zu)\n",
+        old.ns_per_session, old.bytes_per_session, old.allocs_per_session, old_ok);
+    std::printf("  Session (arena)      : %7.1f ns/session %7.1f bytes/session %5.2f allocs/session (ok %zu)\n",
+        fresh.ns_per_session, fresh.bytes_per_session, fresh.allocs_per_session, new_ok);
+    std::printf("  Session (free list)  : %7.1f ns/session %7.1f bytes/session %5.2f allocs/session\n",
+        reuse.ns_per_session, reuse.bytes_per_session, reuse.allocs_per_session);
+    std::printf("  long-key churn 5x100k: reserved %zu -> %zu bytes (%s), key > %zu bytes %s\n",
+        reserved.front(), reserved.back(), churn_flat ? "flat" : "GROWING",
+        Alpha::Session::kMaxKey, too_long_rejected ? "rejected" : "ACCEPTED");
+    std::printf("  pause between step() calls %s, after resume() %s\n",
+        paused_trapped ? "trapped" : "NOT TRAPPED", parked_trapped ? "TRAPPED" : "not trapped");
+
+    return (old_ok == kSessions && new_ok == kSessions && churn_flat && too_long_rejected && clock_ok) ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+﻿#include <iostream>
+#include <string>
+#include <vector>
+#include "Bench.h"
+#include "../Alpha/VirtualMachine.h"
+
+// 长 Key 校验：标量指令集 vs 向量指令集
+// 两种形式校验同一个 Key，时间包含构造 VM 和完整驱动协程
+namespace {
+    bool verify(const std::string& key, const Alpha::Bytecode& code) {
+        Alpha::VirtualMachine vm(key, code);
+        auto task = vm.run();
+        while (!task.done()) task.resume();
+        return vm.is_success();
+    }
+}
+
+int bench_alpha_vec() {
+    const char* kernel =
+#if defined(ALPHA_VEC_AVX2)
+        "AVX2";
+#elif defined(ALPHA_VEC_SSE2)
+        "SSE2";
+#else
+        "scalar";
+#endif
+    std::cout << "vector kernel: " << kernel << "\n";
+
+    int rc = 0;
+    for (size_t len : { 16, 32, 64, 256 }) {
+        std::string key(len, '\0');
+        for (size_t i = 0; i < len; ++i) key[i] = static_cast<char>('!' + (i * 7) % 90);
+        std::string wrong = key;
+        wrong[len - 1] ^= 1;
+
+        auto scalar = Alpha::build_long_program(key, false);
+        auto vector = Alpha::build_long_program(key, true);
+
+        // 先确认两种形式语义一致：正确 Key 通过，错一位就失败
+        if (!verify(key, scalar) || !verify(key, vector) || verify(wrong, scalar) || verify(wrong, vector)) {
+            std::cout << "  len " << len << ": MISMATCH\n";
+            rc = 1;
+            continue;
+        }
+
+        size_t reps = 200000 / len;
+        double ns_scalar = time_ns(reps, [&] { verify(key, scalar); });
+        double ns_vector = time_ns(reps, [&] { verify(key, vector); });
+
+        std::printf("  len %4zu: scalar %5zu insts %10.0f ns | vector %3zu insts %8.0f ns | x%.1f\n",
+            len, scalar.code.size(), ns_scalar, vector.code.size(), ns_vector, ns_scalar / ns_vector);
+    }
+    return rc;
+}
@@ -0,0 +1,35 @@
+﻿#include <iostream>
+#include <string_view>
+#include "Bench.h"
+
+struct BenchEntry {
+    const char* name;
+    int (*fn)();
+};
+
+constexpr BenchEntry benches[] = {
+    { "alpha-vec", bench_alpha_vec },
+    { "alpha-session", bench_alpha_session },
+    { "telemetry-ring", bench_telemetry_ring },
+    { "gamma-narrow", bench_gamma_narrow },
+    { "startup", bench_startup },
+    { "vm-core", bench_vm_core_matrix },
+};
+
+// 用法：Bench [名字]，不带参数时全部运行
+int main(int argc, char** argv) {
+    std::string_view want = argc > 1 ? argv[1] : "";
+    int rc = 0;
+    bool found = false;
+    for (const auto& b : benches) {
+        if (!want.empty() && want != b.name) continue;
+        found = true;
+        std::cout << "=== " << b.name << " ===\n";
+        rc |= b.fn();
+    }
+    if (!found) {
+        std::cout << "unknown benchmark: " << want << "\n";
+        return 1;
+    }
+    return rc;
+}
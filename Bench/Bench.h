@@ -0,0 +1,28 @@
+﻿#pragma once
+#include <chrono>
+#include <cstdio>
+#include <atomic>
+#include <cstddef>
+
+// 每个基准测试一个函数，由 Bench.cpp 按名字分发
+int bench_alpha_vec();
+int bench_alpha_session();
+int bench_telemetry_ring();
+int bench_gamma_narrow();
+int bench_startup();
+int bench_vm_core_matrix();
+
+// AllocCount.cpp 替换了全局 operator new，这里读计数
+namespace AllocCount {
+    extern std::atomic<size_t> calls;
+    extern std::atomic<size_t> bytes;
+}
+
+// 计时小工具：返回调用 f() n 次的平均纳秒数
+template <typename F>
+double time_ns(size_t n, F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
@@ -0,0 +1,91 @@
+﻿#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include "Bench.h"
+#include "../Gamma/Narrow.h"
+#include "../Gamma_keygen/Keygen.h"
+
+// Gamma 窄位宽批量求值：16 位 x16 / 8 位 x32 对比逐个 64 位参考求值
+// 所有结果都和参考求值器逐字节比对；这里验证的是等价性，窄求值不是吞吐路径（见 Narrow.h）
+namespace {
+    constexpr std::string_view kPlaintext = "Congratulations! The Gamma core is dissolved.";
+
+    template <typename Lane, size_t B>
+    bool run(const char* label, std::span<const std::string_view> keys, std::span<const std::span<const uint8_t>> code,
+        const std::vector<std::array<uint8_t, 16>>& expect, double ns_ref)
+    {
+        size_t fallbacks = 0;
+        std::vector<std::array<uint8_t, 16>> got;
+        double ns = time_ns(1, [&] { got = Narrow::evaluate_all<Lane, B>(keys, code, kPlaintext.size(), &fallbacks); }) / keys.size();
+        bool same = got == expect;
+        std::printf("    %-10s %7.0f ns/key  x%.2f  fallback %6zu/%zu  %s\n",
+            label, ns, ns_ref / ns, fallbacks, keys.size(), same ? "exact" : "MISMATCH");
+        return same;
+    }
+
+    bool scenario(const char* name, std::span<const std::string_view> keys, std::span<const std::span<const uint8_t>> code) {
+        std::vector<std::array<uint8_t, 16>> expect(keys.size());
+        size_t narrowable = 0;
+        std::array<size_t, 65> widths{};
+        double ns_ref = time_ns(1, [&] {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                auto t = Narrow::reference(keys[i], code[code.size() == 1 ? 0 : i]);
+                for (int j = 0; j < 16; ++j) expect[i][j] = static_cast<uint8_t>(t.final_regs[j]);
+            }
+        }) / keys.size();
+
+        for (size_t i = 0; i < keys.size(); ++i) {
+            auto d = Narrow::analyze(Narrow::reference(keys[i], code[code.size() == 1 ? 0 : i]), kPlaintext.size());
+            ++widths[d.max_width];
+            narrowable += d.max_width <= 8;
+        }
+
+        std::printf("  %s: %zu keys, demanded width 8/16/32/64 = %zu/%zu/%zu/%zu\n",
+            name, keys.size(), widths[8], widths[16], widths[32], widths[64]);
+        std::printf("    %-10s %7.0f ns/key\n", "reference", ns_ref);
+
+        bool ok = true;
+        ok &= run<uint16_t, 16>("u16 x16", keys, code, expect, ns_ref);
+        ok &= run<uint8_t, 32>("u8 x32", keys, code, expect, ns_ref);
+
+        // 分析认为 8 位足够的 Key，窄求值必须精确；反过来回退次数不会少于分析给出的宽 Key
+        size_t fallbacks = 0;
+        Narrow::evaluate_all<uint8_t, 32>(keys, code, kPlaintext.size(), &fallbacks);
+        if (fallbacks > keys.size() - narrowable) {
+            std::printf("    analysis says %zu keys fit 8 bits but %zu fell back\n", narrowable, fallbacks);
+            ok = false;
+        }
+        return ok;
+    }
+}
+
+int bench_gamma_narrow() {
+    constexpr size_t kKeys = 8192;
+
+    // 场景一：批量校验已签发的许可证，每个 Key 带自己的程序镜像
+    std::vector<std::string> owned(kKeys);
+    std::vector<Keygen::Image> images(kKeys);
+    std::vector<std::string_view> keys(kKeys);
+    std::vector<std::span<const uint8_t>> codes(kKeys);
+    for (size_t i = 0; i < kKeys; ++i) {
+        owned[i] = "customer-" + std::to_string(i);
+        images[i] = Keygen::generate(owned[i], kPlaintext);
+        keys[i] = owned[i];
+        codes[i] = images[i].code;
+    }
+    bool ok = scenario("issued licences", keys, codes);
+
+    // 场景二：对同一个镜像猜随机 Key
+    std::mt19937_64 rng(1);
+    std::vector<std::string> guesses(kKeys);
+    for (size_t i = 0; i < kKeys; ++i) {
+        guesses[i].resize(8);
+        for (auto& c : guesses[i]) c = static_cast<char>('a' + rng() % 26);
+        keys[i] = guesses[i];
+    }
+    std::span<const uint8_t> one[] = { images[0].code };
+    ok &= scenario("random guesses", keys, one);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+﻿#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include "Bench.h"
+
+// 冷启动：从拉起进程到输出判定结果并退出的墙钟时间，默认模式 vs --fast-start
+// 类似 perf stat -r：每种配置重复多次，给出均值和相对标准差
+// 可执行文件从 CRACKME_BIN_DIR 找（默认当前目录），找不到的跳过
+namespace {
+    constexpr int kRuns = 20;
+
+#if defined(_WIN32)
+    constexpr const char* kExeSuffix = ".exe";
+    constexpr const char* kNull = "NUL";
+#else
+    constexpr const char* kExeSuffix = "";
+    constexpr const char* kNull = "/dev/null";
+#endif
+
+    struct Stat {
+        double mean_ms;
+        double rel_sd;
+    };
+
+    Stat measure(const std::string& cmd) {
+        std::vector<double> ms;
+        ms.reserve(kRuns);
+        for (int i = 0; i < kRuns; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            if (std::system(cmd.c_str()) != 0) return { -1, 0 };
+            auto t1 = std::chrono::steady_clock::now();
+            ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        }
+        double mean = 0;
+        for (double v : ms) mean += v;
+        mean /= ms.size();
+        double var = 0;
+        for (double v : ms) var += (v - mean) * (v - mean);
+        return { mean, mean > 0 ? std::sqrt(var / (ms.size() - 1)) / mean : 0 };
+    }
+
+    void report(const char* label, Stat s) {
+        if (s.mean_ms < 0) std::printf("    %-22s failed\n", label);
+        else std::printf("    %-22s %8.2f ms  ( +- %4.1f%% )\n", label, s.mean_ms, 100 * s.rel_sd);
+    }
+}
+
+int bench_startup() {
+    namespace fs = std::filesystem;
+    const char* env = std::getenv("CRACKME_BIN_DIR");
+    fs::path dir = env ? env : ".";
+
+    // 输入随便给一个 Key，判定对错都要走完整个 VM
+    fs::path input = fs::temp_directory_path() / "crackme_startup_key.txt";
+    std::ofstream(input) << "startup-probe\n";
+
+    std::printf("  %d runs each, binaries from %s\n", kRuns, dir.string().c_str());
+    // 只拉起一个 shell 的开销，下面每一行都包含这一部分
+    report("shell baseline", measure("exit 0"));
+
+    bool any = false;
+    for (const char* name : { "Alpha", "Beta", "Gamma" }) {
+        fs::path exe = dir / (std::string(name) + kExeSuffix);
+        if (!fs::exists(exe)) {
+            std::printf("  %s: not found, skipped\n", exe.string().c_str());
+            continue;
+        }
+        any = true;
+        std::string base = "\"" + exe.string() + "\"";
+        std::string redirect = " < \"" + input.string() + "\" > " + kNull;
+
+        std::printf("  %s\n", name);
+        Stat slow = measure(base + redirect);
+        Stat fast = measure(base + " --fast-start" + redirect);
+        report("default", slow);
+        report("--fast-start", fast);
+        if (slow.mean_ms > 0 && fast.mean_ms > 0) std::printf("    speedup x%.1f\n", slow.mean_ms / fast.mean_ms);
+    }
+
+    fs::remove(input);
+    if (!any) std::printf("  set CRACKME_BIN_DIR to the directory holding Alpha/Beta/Gamma\n");
+    return 0;
+}
@@ -0,0 +1,54 @@
+﻿#include <iostream>
+#include <thread>
+#include "Bench.h"
+#include "../Shared/Telemetry.h"
+
+// 生产者每步的额外开销：现有心跳 vs 心跳 + 事件入队
+// 消费者线程按巡逻线程的节奏成批取走，满了就丢
+namespace {
+    constexpr size_t kSteps = 20'000'000;
+
+    std::atomic<int64_t> heartbeat{ 0 };
+    Telemetry::SpscRing<4096> ring;
+
+    void beat() {
+        heartbeat.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+}
+
+int bench_telemetry_ring() {
+    double ns_beat = time_ns(kSteps, beat);
+
+    std::atomic<bool> running{ true };
+    Telemetry::StepMonitor monitor(200'000'000);
+    std::thread consumer([&] {
+        while (running.load(std::memory_order_relaxed)) {
+            monitor.tick(std::chrono::steady_clock::now().time_since_epoch().count(), Telemetry::read_tsc());
+            ring.drain([&](std::span<const Telemetry::StepEvent> batch) { monitor.observe(batch); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ring.drain([&](std::span<const Telemetry::StepEvent> batch) { monitor.observe(batch); });
+        });
+
+    uint32_t pc = 0;
+    double ns_push = time_ns(kSteps, [&] {
+        ring.push({ pc, static_cast<uint16_t>(pc & 3), 0, Telemetry::read_tsc() });
+        ++pc;
+        });
+    double ns_both = time_ns(kSteps, [&] {
+        beat();
+        ring.push({ pc, static_cast<uint16_t>(pc & 3), 0, Telemetry::read_tsc() });
+        ++pc;
+        });
+
+    running = false;
+    consumer.join();
+
+    std::printf("  heartbeat only     : %6.2f ns/step\n", ns_beat);
+    std::printf("  ring push (rdtsc)  : %6.2f ns/step\n", ns_push);
+    std::printf("  heartbeat + push   : %6.2f ns/step\n", ns_both);
+    std::printf("  consumed %llu, dropped %llu of %zu (capacity %zu, 1 ms drain period)\n",
+        (unsigned long long)monitor.events, (unsigned long long)ring.dropped_count(), 2 * kSteps, ring.capacity());
+
+    return monitor.events + ring.dropped_count() == 2 * kSteps ? 0 : 1;
+}
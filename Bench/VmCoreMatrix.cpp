@@ -0,0 +1,123 @@
+﻿#include <iostream>
+#include <vector>
+#include <array>
+#include <string>
+#include <bit>
+#include "Bench.h"
+#include "../Beta/Common.h"
+#include "../Shared/VmCore.h"
+
+// VmCore 策略矩阵：分派 x 反调试 x 分支 x 调度，全部 36 种组合跑同一段程序
+// 用 Beta 指令集，每 5 条指令有一次跳转（断言失败跳到下一条），分支策略的差别能显出来
+// 所有组合的最终寄存器必须一致
+namespace {
+    constexpr size_t kBlocks = 1024;
+    constexpr int kRuns = 20;
+
+    constinit Telemetry::SpscRing<8192> events;
+    std::atomic<int64_t> heartbeat{ 0 };
+    void feed() { heartbeat.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed); }
+
+    std::vector<Beta::Instruction> make_program() {
+        std::vector<Beta::Instruction> code;
+        for (size_t i = 0; i < kBlocks; ++i) {
+            code.push_back(Beta::OpLoadByte{ 0, i % 16 });
+            code.push_back(Beta::OpAdd{ 1, 0 });
+            code.push_back(Beta::OpXor{ 2, 1 });
+            code.push_back(Beta::OpRol{ 2, 5 });
+            code.push_back(Beta::OpAssertEq{ 2, 0, static_cast<int>(code.size() + 1) });
+        }
+        return code;
+    }
+
+    template <typename Core>
+    struct Machine {
+        std::array<uint64_t, 8> regs{};
+        const std::vector<Beta::Instruction>& code;
+        std::string_view input;
+
+        bool done(size_t pc) const { return pc >= code.size(); }
+        const Beta::Instruction& fetch(size_t pc) const { return code[pc]; }
+        void tamper() { regs[7] ^= 1; }
+        void finish() {}
+
+        template <typename T>
+        VmCore::Next operator()(const T& arg, size_t) {
+            using namespace Beta;
+            if constexpr (std::is_same_v<T, OpLoadByte>) regs[arg.reg] = static_cast<uint8_t>(input[arg.idx % input.size()]);
+            else if constexpr (std::is_same_v<T, OpAdd>) regs[arg.r1] += regs[arg.r2];
+            else if constexpr (std::is_same_v<T, OpXor>) regs[arg.r1] ^= regs[arg.r2];
+            else if constexpr (std::is_same_v<T, OpRol>) regs[arg.r1] = std::rotl(regs[arg.r1], arg.shift);
+            else if constexpr (std::is_same_v<T, OpAssertEq>) {
+                if (regs[arg.r1] != arg.val) return Core::branch::take(arg.fail_jump);
+            }
+            return VmCore::kNext;
+        }
+    };
+
+    template <typename T> constexpr const char* name = "?";
+    template <> constexpr const char* name<VmCore::Visit> = "visit";
+    template <> constexpr const char* name<VmCore::Switch> = "switch";
+    template <> constexpr const char* name<VmCore::Threaded> = "threaded";
+    template <> constexpr const char* name<VmCore::NoCheck> = "none";
+    template <> constexpr const char* name<VmCore::InlineClock<100>> = "clock";
+    template <> constexpr const char* name<VmCore::Watchdog<events, feed>> = "watchdog";
+    template <> constexpr const char* name<VmCore::Exceptions> = "exceptions";
+    template <> constexpr const char* name<VmCore::Values> = "values";
+    template <> constexpr const char* name<VmCore::YieldEvery<1>> = "yield/1";
+    template <> constexpr const char* name<VmCore::YieldEvery<64>> = "yield/64";
+
+    template <typename... Ts> struct List {};
+
+    template <typename... Ts, typename F>
+    void each(List<Ts...>, F&& f) { (f(Ts{}), ...); }
+
+    template <typename D, typename A, typename B, typename S>
+    std::array<uint64_t, 8> measure(const std::vector<Beta::Instruction>& code, double& ns_step) {
+        using Core = VmCore::Core<D, A, B, S>;
+        std::array<uint64_t, 8> regs{};
+        ns_step = time_ns(kRuns, [&] {
+            Machine<Core> m{ {}, code, "policy-matrix-input" };
+            auto task = Core::run(m);
+            while (!task.done()) task.resume();
+            regs = m.regs;
+            events.drain([](std::span<const Telemetry::StepEvent>) {});
+            }) / code.size();
+        return regs;
+    }
+}
+
+int bench_vm_core_matrix() {
+    auto code = make_program();
+    std::printf("  %zu instructions, %zu taken branches per run\n", code.size(), kBlocks);
+    std::printf("  %-9s %-9s %-11s %-9s %9s\n", "dispatch", "anti-dbg", "branch", "schedule", "ns/step");
+
+    using Dispatches = List<VmCore::Visit, VmCore::Switch, VmCore::Threaded>;
+    using AntiDebugs = List<VmCore::NoCheck, VmCore::InlineClock<100>, VmCore::Watchdog<events, feed>>;
+    using Branches = List<VmCore::Exceptions, VmCore::Values>;
+    using Schedules = List<VmCore::YieldEvery<1>, VmCore::YieldEvery<64>>;
+
+    std::array<uint64_t, 8> expect{};
+    bool first = true, ok = true;
+    each(Dispatches{}, [&](auto d) {
+        each(AntiDebugs{}, [&](auto a) {
+            each(Branches{}, [&](auto b) {
+                each(Schedules{}, [&](auto s) {
+                    using D = decltype(d);
+                    using A = decltype(a);
+                    using B = decltype(b);
+                    using S = decltype(s);
+                    double ns = 0;
+                    auto regs = measure<D, A, B, S>(code, ns);
+                    if (first) expect = regs;
+                    first = false;
+                    bool same = regs == expect;
+                    ok &= same;
+                    std::printf("  %-9s %-9s %-11s %-9s %9.1f%s\n",
+                        name<D>, name<A>, name<B>, name<S>, ns, same ? "" : "  MISMATCH");
+                    });
+                });
+            });
+        });
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+#include <vector>
+#include <variant>
+#include <cstdint>
+#include <cstddef>
+
+// Beta 指令集：必须保证 CrackMe 和 Solver 完全一致
+namespace Beta {
+    struct OpLoadByte { int reg; size_t idx; }; // 从输入取字节
+    struct OpAdd { int r1; int r2; };
+    struct OpXor { int r1; int r2; };
+    struct OpRol { int r1; int shift; }; // 循环左移
+    struct OpAssertEq { int r1; uint64_t val; int fail_jump; }; // 核心：断言失败则抛异常跳转
+
+    using Instruction = std::variant<OpLoadByte, OpAdd, OpXor, OpRol, OpAssertEq>;
+
+    // 字节码依赖输入长度：长度不对时会插入一条永远不成立的断言
+    inline std::vector<Instruction> build_program(size_t input_len) {
+        std::vector<Instruction> code;
+
+        // 1. 长度检查
+        if (input_len != 4) {
+            // 故意用一个永远不会成立的断言来触发 999 错误分支
+            code.push_back(OpAssertEq{ 0, 0xDEADBEEFULL, 999 });
+        }
+
+        // 2. 验证 'B' -> R0 变为 0x84
+        code.push_back(OpLoadByte{ 0, 0 });
+        code.push_back(OpAdd{ 0, 0 });
+        code.push_back(OpAssertEq{ 0, 0x84ULL, 999 });
+
+        // 3. 验证 'E' -> R1 变为 0xC1
+        code.push_back(OpLoadByte{ 1, 1 });
+        code.push_back(OpXor{ 1, 0 });
+        code.push_back(OpAssertEq{ 1, 0xC1ULL, 999 });
+
+        // 4. 验证 'T' -> R2 变为 0x1150
+        code.push_back(OpLoadByte{ 2, 2 });
+        code.push_back(OpAdd{ 2, 1 });
+        code.push_back(OpRol{ 2, 4 });
+        code.push_back(OpAssertEq{ 2, 0x1150ULL, 999 });
+
+        // 5. 验证 '@' -> R3 变为 0x1194
+        code.push_back(OpLoadByte{ 3, 3 });
+        code.push_back(OpXor{ 3, 2 });
+        code.push_back(OpXor{ 3, 0 });
+        code.push_back(OpAssertEq{ 3, 0x1194ULL, 999 });
+
+        code.push_back(OpXor{ 0, 3 });                 // R0 = 0x84 ^ 0x1194 = 0x1110
+        code.push_back(OpAssertEq{ 0, 0x1110ULL, 999 }); // 验证中间混淆状态
+        code.push_back(OpXor{ 0, 3 });                 // R0 = 0x1110 ^ 0x1194 = 0x84 (还原成功!)
+
+        return code;
+    }
+}
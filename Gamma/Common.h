@@ -16,12 +16,18 @@ public:
         }
     }
 
-    uint8_t next_byte() {
-        uint64_t x = state;
+    // 单步 xorshift，批量求值时对一组裸状态直接调用
+    static constexpr uint64_t advance(uint64_t x) {
         x ^= x << 13;
         x ^= x >> 7;
         x ^= x << 17;
-        state = x;
+        return x;
+    }
+
+    uint8_t next_byte() {
+        state = advance(state);
         return static_cast<uint8_t>(state & 0xFF);
     }
+
+    uint64_t raw_state() const { return state; }
 };
\ No newline at end of file
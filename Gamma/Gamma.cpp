@@ -14,24 +14,14 @@
 #include <concepts>
 #include <span>
 #include "key.h"
+#include "../Shared/Telemetry.h"
+#include "../Shared/FastStart.h"
+#include "../Shared/VmCore.h"
 
 // ==========================================
 // 1. 编译期混淆
 // ==========================================
-template <size_t N>
-struct XStr {
-    std::array<char, N> buffer;
-    uint8_t k;
-    consteval XStr(const char(&str)[N]) : k(0xAA) {
-        for (size_t i = 0; i < N; ++i) buffer[i] = str[i] ^ k ^ (i % 13);
-    }
-    std::string s() const {
-        std::string res(N, '\0');
-        for (size_t i = 0; i < N; ++i) res[i] = buffer[i] ^ k ^ (i % 13);
-        return res.data();
-    }
-};
-#define _S(x) XStr<sizeof(x)>(x).s()
+#define _S(x) VmCore::XStr<sizeof(x), 0xAA, 13>(x).s()
 
 // ==========================================
 // 2. 混沌引擎
@@ -66,24 +56,32 @@ public:
 // ==========================================
 namespace Watchdog {
     std::atomic<uint64_t> last_tick{ 0 };
-    std::atomic<bool> active{ true };
     // 污染因子：如果被调试，这个值会变成非0，彻底破坏解密结果
     std::atomic<uint8_t> pollution{ 0 };
 
+    // 每一步的 (pc, opcode, tsc)，巡逻线程成批取走
+    // constinit：全部在编译期初始化，启动时不跑任何构造函数
+    constinit Telemetry::SpscRing<4096> events;
+    constinit Telemetry::StepMonitor monitor(200'000'000);
+
+    // 巡逻一次，由守护线程每 50ms 调用
     void patrol() {
-        while (active) {
-            auto now = std::chrono::steady_clock::now().time_since_epoch().count();
-            auto last = last_tick.load(std::memory_order_relaxed);
-
-            if (last != 0) {
-                // 阈值检测：单位纳秒
-                // 如果主线程停顿超过 200ms
-                if ((now - last) > 200'000'000) {
-                    pollution = 0xFF; // 注入毒药
-                }
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto last = last_tick.load(std::memory_order_relaxed);
+
+        if (last != 0) {
+            // 阈值检测：单位纳秒
+            // 如果主线程停顿超过 200ms
+            if ((now - last) > 200'000'000) {
+                pollution = 0xFF; // 注入毒药
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
         }
+
+        // 两步之间的 TSC 间隔过大：断点落在了某条指令上
+        monitor.tick(now, Telemetry::read_tsc());
+        events.drain([](std::span<const Telemetry::StepEvent> batch) {
+            if (monitor.observe(batch)) pollution = 0xFF;
+            });
     }
 
     void feed() {
@@ -104,120 +102,119 @@ using Instruction = std::variant<InstMath, InstMov, InstJmp, InstSys>;
 
 // ==========================================
 // 5. 动态虚拟机
+// 骨架见 Shared/VmCore.h：std::visit 分派、巡逻线程反调试、
+// 跳转目标走返回值、每步挂起一次协程
 // ==========================================
 
-struct VmTask {
-    struct promise_type {
-        VmTask get_return_object() { return VmTask{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
-        std::suspend_always initial_suspend() { return {}; }
-        std::suspend_always final_suspend() noexcept { return {}; }
-        void return_void() {}
-        void unhandled_exception() { std::terminate(); }
-        std::suspend_always yield_value(bool) { return {}; }
-    };
-    std::coroutine_handle<promise_type> h;
-    explicit VmTask(std::coroutine_handle<promise_type> h) : h(h) {}
-    ~VmTask() { if (h) h.destroy(); }
-    void resume() { if (h && !h.done()) h.resume(); }
-    bool done() const { return !h || h.done(); }
-};
+using Core = VmCore::Core<VmCore::Visit, VmCore::Watchdog<Watchdog::events, Watchdog::feed>,
+    VmCore::Values, VmCore::YieldEvery<1>>;
 
 class GammaVM {
     std::array<uint64_t, 16> regs = { 0 };
 
-    // 这里将由 Keygen 生成的数据填充
-    std::vector<uint8_t> code_store;
-    std::vector<uint8_t> cipher_store;
-
     ChaosEngine chaos;
 
+    // 这里将由 Keygen 生成的数据填充，直接引用只读段里的常量，不做拷贝
+    std::span<const uint8_t> code_store;
+    std::span<const uint8_t> cipher_store;
+
+    int steps = 0;
+    std::string* out = nullptr;
+
 public:
     // 构造函数接收 Key，同时也需要外部传入生成好的静态数据
     GammaVM(std::string_view key,
-        const std::vector<uint8_t>& code,
-        const std::vector<uint8_t>& cipher)
+        std::span<const uint8_t> code,
+        std::span<const uint8_t> cipher)
         : chaos(key), code_store(code), cipher_store(cipher)
     {
         // 初始化寄存器
         for (auto& r : regs) r = chaos.next_byte();
     }
 
-    VmTask run(std::string& out_ref) {
-        int pc = 0;
-        int steps = 0;
-
-        // 必须和 Keygen 一致，运行 256 步
-        while (steps < 256) {
-            Watchdog::feed();
-
-            // 1. 取指
-            // 注意：现在我们用 code_store
-            uint8_t raw_byte = code_store[pc % code_store.size()];
-            uint8_t decrypt_mask = chaos.next_byte();
-            uint8_t poison = Watchdog::pollution.load();
-
-            uint8_t op = raw_byte ^ decrypt_mask ^ poison;
-
-            // 2. 将字节映射为指令 Variant (Polymorphism)
-            Instruction inst;
-            switch (op % 4) {
-            case 0: inst = InstMath{ static_cast<uint8_t>(chaos.next_byte() % 4) }; break;
-            case 1: inst = InstMov{}; break;
-            case 2: inst = InstJmp{}; break;
-            default: inst = InstSys{}; break;
-            }
+    VmCore::Task run(std::string& out_ref) {
+        out = &out_ref;
+        return Core::run(*this);
+    }
+
+    // --- 骨架回调 ---
+
+    // 必须和 Keygen 一致，运行 256 步
+    bool done(size_t) const { return steps >= 256; }
+
+    Instruction fetch(size_t pc) {
+        ++steps;
 
-            // 3. 执行 (Execute)
-            // 所有的内存访问都取模，保证“乱跑”也不会崩溃 (No Crash)
-            std::visit([&](auto&& arg) {
-                using T = std::decay_t<decltype(arg)>;
-
-                // 获取操作数（同样也是动态解密的）
-                uint8_t op1_idx = chaos.next_byte() % 16;
-                uint8_t op2_idx = chaos.next_byte() % 16;
-
-                if constexpr (std::is_same_v<T, InstMath>) {
-                    switch (arg.opcode_type) {
-                    case 0: regs[op1_idx] += regs[op2_idx]; break;
-                    case 1: regs[op1_idx] -= regs[op2_idx]; break;
-                    case 2: regs[op1_idx] ^= regs[op2_idx]; break;
-                    case 3: regs[op1_idx] *= (regs[op2_idx] | 1); break; // 防止乘0清空
-                    }
-                }
-                else if constexpr (std::is_same_v<T, InstMov>) {
-                    regs[op1_idx] = regs[op2_idx];
-                }
-                else if constexpr (std::is_same_v<T, InstJmp>) {
-                    // 即使乱跳也是在 encrypted_code 的范围内循环
-                    pc += (regs[op1_idx] & 0x1F);
-                }
-                else if constexpr (std::is_same_v<T, InstSys>) {
-                    // 对寄存器进行混淆变换
-                    regs[0] = std::rotl(regs[0], 3);
-                }
-                }, inst);
-
-            pc++;
-            steps++;
-
-            // 协程切换：打碎调用栈
-            co_yield true;
+        // 1. 取指
+        // 注意：现在我们用 code_store
+        uint8_t raw_byte = code_store[pc % code_store.size()];
+        uint8_t decrypt_mask = chaos.next_byte();
+        uint8_t poison = Watchdog::pollution.load();
+
+        uint8_t op = raw_byte ^ decrypt_mask ^ poison;
+
+        // 2. 将字节映射为指令 Variant (Polymorphism)
+        switch (op % 4) {
+        case 0: return InstMath{ static_cast<uint8_t>(chaos.next_byte() % 4) };
+        case 1: return InstMov{};
+        case 2: return InstJmp{};
+        default: return InstSys{};
         }
+    }
 
-        // 4. 结果生成
-        // 使用 cipher_store 进行解密
+    // 3. 执行 (Execute)
+    // 所有的内存访问都取模，保证“乱跑”也不会崩溃 (No Crash)
+    template <typename T>
+    VmCore::Next operator()(const T& arg, size_t pc) {
+        // 获取操作数（同样也是动态解密的）
+        uint8_t op1_idx = chaos.next_byte() % 16;
+        uint8_t op2_idx = chaos.next_byte() % 16;
+
+        if constexpr (std::is_same_v<T, InstMath>) {
+            switch (arg.opcode_type) {
+            case 0: regs[op1_idx] += regs[op2_idx]; break;
+            case 1: regs[op1_idx] -= regs[op2_idx]; break;
+            case 2: regs[op1_idx] ^= regs[op2_idx]; break;
+            case 3: regs[op1_idx] *= (regs[op2_idx] | 1); break; // 防止乘0清空
+            }
+        }
+        else if constexpr (std::is_same_v<T, InstMov>) {
+            regs[op1_idx] = regs[op2_idx];
+        }
+        else if constexpr (std::is_same_v<T, InstJmp>) {
+            // 即使乱跳也是在 encrypted_code 的范围内循环
+            return Core::branch::take(pc + (regs[op1_idx] & 0x1F) + 1);
+        }
+        else if constexpr (std::is_same_v<T, InstSys>) {
+            // 对寄存器进行混淆变换
+            regs[0] = std::rotl(regs[0], 3);
+        }
+        return VmCore::kNext;
+    }
+
+    // 检测在巡逻线程里做，毒药直接混进取指
+    void tamper() {}
+
+    // 4. 结果生成
+    // 使用 cipher_store 进行解密
+    void finish() {
         std::string result = "";
         for (size_t i = 0; i < cipher_store.size(); ++i) {
             char k = static_cast<char>(regs[i % 16] & 0xFF);
             result += (char)(cipher_store[i] ^ k);
         }
 
-        out_ref = result;
+        *out = result;
     }
 };
 
-int main() {
-    std::jthread dog(Watchdog::patrol);
+int main(int argc, char** argv) {
+    // 只用 iostream，不需要和 C stdio 同步
+    std::ios::sync_with_stdio(false);
+
+    bool fast = FastStart::requested(argc, argv);
+    FastStart::Sentry dog;
+    if (!fast) dog.start(Watchdog::patrol, std::chrono::milliseconds(50));
 
     std::cout << _S("\n=== GAMMA SECURITY LAYER ===\n");
     std::cout << _S("Input Authorization Key: ");
@@ -230,12 +227,15 @@ int main() {
     GammaVM vm(key, encrypted_code, secret_cipher);
     auto task = vm.run(output);
 
+    // 冷启动模式：守护线程到这里才创建
+    dog.start(Watchdog::patrol, std::chrono::milliseconds(50));
+
     while (!task.done()) {
         task.resume();
-        std::this_thread::sleep_for(std::chrono::microseconds(1));
+        FastStart::pace(fast, std::chrono::microseconds(1));
     }
 
-    Watchdog::active = false;
+    dog.stop();
     std::cout << _S("System Output: [ ") << output << _S(" ]") << std::endl;
 
     return 0;
@@ -0,0 +1,301 @@
+﻿#pragma once
+#include <array>
+#include <vector>
+#include <span>
+#include <string_view>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "Common.h"
+
+// ==========================================
+// 窄位宽求值
+// 输出只用到寄存器低 8 位，InstJmp 只读低 5 位，加减乘异或和 MOV 只把低位往高位传。
+// 唯一把高位拉下来的是 InstSys 的 rotl(regs[0], 3)。
+// 这里给出：参考求值器（记录解码轨迹）、对轨迹做的逆向 demanded-bits 分析、
+// 以及按 8/16 位打包多个 Key 的批量求值器（带逐 lane 的正确性保护）。
+//
+// 批量求值器用来验证窄位宽的等价性，不是吞吐路径：
+//   - 每步的取指是逐 lane 的 gather，解码要推进 64 位 xorshift，SSE2 一个寄存器只放两个 lane；
+//   - 按寄存器号取操作数和写回都是 16 路掩码选择。
+//   这三块和 lane 位宽无关，在 -O2 / SSE2 下比逐个跑 reference() 慢，AVX2 下也只是持平上下。
+//   rotl(regs[0], 3) 会把 bit 61-63 拉进被需要的低位，analyze() 实际只给出 8 位或 64 位，
+//   不存在值得单独走一遍 16 位的 Key。
+// ==========================================
+namespace Narrow {
+    constexpr size_t kSteps = 256; // 必须和 GammaVM::run 一致
+
+    enum Kind : uint8_t { Math = 0, Mov = 1, Jmp = 2, Sys = 3 };
+
+    struct TraceStep { uint8_t kind; uint8_t math; uint8_t op1; uint8_t op2; };
+
+    struct Trace {
+        std::vector<TraceStep> steps;
+        std::array<uint64_t, 16> final_regs{};
+    };
+
+    // ==========================================
+    // 1. 参考求值器：逐字节照搬 GammaVM::run（pollution 视为 0）
+    // ==========================================
+    inline Trace reference(std::string_view key, std::span<const uint8_t> code) {
+        ChaosEngine chaos(key);
+        std::array<uint64_t, 16> regs{};
+        for (auto& r : regs) r = chaos.next_byte();
+
+        Trace t;
+        t.steps.reserve(kSteps);
+        size_t pc = 0;
+        for (size_t step = 0; step < kSteps; ++step) {
+            uint8_t op = code[pc % code.size()] ^ chaos.next_byte();
+            TraceStep s{ static_cast<uint8_t>(op % 4), 0, 0, 0 };
+            if (s.kind == Math) s.math = chaos.next_byte() % 4;
+            s.op1 = chaos.next_byte() % 16;
+            s.op2 = chaos.next_byte() % 16;
+
+            uint64_t& a = regs[s.op1];
+            uint64_t b = regs[s.op2];
+            switch (s.kind) {
+            case Math:
+                switch (s.math) {
+                case 0: a += b; break;
+                case 1: a -= b; break;
+                case 2: a ^= b; break;
+                case 3: a *= static_cast<uint64_t>(b | 1); break; // 64 位无符号乘法不做整数提升，回绕有定义
+                }
+                break;
+            case Mov: a = b; break;
+            case Jmp: pc += (a & 0x1F); break;
+            case Sys: regs[0] = std::rotl(regs[0], 3); break;
+            }
+            ++pc;
+            t.steps.push_back(s);
+        }
+        t.final_regs = regs;
+        return t;
+    }
+
+    // ==========================================
+    // 2. Demanded-bits 分析：从输出往回推，每个寄存器在整个轨迹上需要的最高位
+    // ==========================================
+    struct Demand {
+        std::array<uint64_t, 16> mask{};  // 整个轨迹上该寄存器被需要过的位
+        std::array<uint8_t, 16> width{};  // 安全的最窄 lane 宽度：8/16/32/64
+        uint8_t max_width = 8;
+    };
+
+    // 加减乘的结果低 n 位只依赖操作数的低 n 位
+    inline uint64_t low_closure(uint64_t m) {
+        return m ? (~0ULL >> std::countl_zero(m)) : 0;
+    }
+
+    inline Demand analyze(const Trace& t, size_t out_len) {
+        std::array<uint64_t, 16> live{};
+        for (size_t i = 0; i < out_len; ++i) live[i % 16] |= 0xFF;
+
+        Demand d;
+        for (int r = 0; r < 16; ++r) d.mask[r] = live[r];
+
+        for (size_t i = t.steps.size(); i-- > 0;) {
+            const TraceStep& s = t.steps[i];
+            uint64_t need = live[s.op1];
+            switch (s.kind) {
+            case Math: {
+                uint64_t src = s.math == 2 ? need : low_closure(need);
+                live[s.op1] = src;
+                live[s.op2] |= src;
+                break;
+            }
+            case Mov:
+                live[s.op1] = 0;
+                live[s.op2] |= need;
+                break;
+            case Jmp:
+                live[s.op1] |= 0x1F;
+                break;
+            case Sys:
+                live[0] = std::rotr(live[0], 3);
+                break;
+            }
+            for (int r = 0; r < 16; ++r) d.mask[r] |= live[r];
+        }
+
+        d.max_width = 8;
+        for (int r = 0; r < 16; ++r) {
+            int bits = 64 - std::countl_zero(d.mask[r]);
+            d.width[r] = bits <= 8 ? 8 : bits <= 16 ? 16 : bits <= 32 ? 32 : 64;
+            if (d.width[r] > d.max_width) d.max_width = d.width[r];
+        }
+        return d;
+    }
+
+    // ==========================================
+    // 3. 批量求值：B 个 Key 同步执行，寄存器按 Lane 位宽打包成结构数组，
+    // 除了取指，按 lane 的循环都是定长、无分支的。
+    // 一个 AVX2 寄存器放 32 个 8 位 lane，而 64 位只能放 4 个；但解码用的 64 位状态不受 Lane 影响。
+    //
+    // 正确性保护（前向的 demanded-bits）：窄 lane 里 rotl 拿不到高位，
+    // 于是把 R0 标记为“可能错误”，错误沿数据流传播。跳转读到错误寄存器
+    // 或者输出用到错误寄存器时，这个 lane 不精确，需要回退到参考求值器。
+    // ==========================================
+    template <typename Lane, size_t B>
+    struct BatchResult {
+        std::array<std::array<uint8_t, 16>, B> low{}; // 最终每个寄存器的低 8 位
+        std::array<bool, B> exact{};
+    };
+
+    // 条件全 1 / 全 0 的掩码和按掩码选择。写成 ?: 或 && 时 GCC 会生成逐 lane 的分支，
+    // 随机数据下预测全错，比 64 位逐个执行还慢
+    template <typename T>
+    constexpr T mask_of(bool c) { return static_cast<T>(-static_cast<T>(c)); }
+
+    template <typename T>
+    constexpr T blend(T m, T a, T b) { return static_cast<T>((a & m) | (b & ~m)); }
+
+    template <typename Lane, size_t B>
+    BatchResult<Lane, B> evaluate_batch(const std::array<std::string_view, B>& keys,
+        const std::array<std::span<const uint8_t>, B>& code, size_t out_len)
+    {
+        static_assert(std::is_unsigned_v<Lane>);
+        constexpr bool full = sizeof(Lane) == sizeof(uint64_t);
+        constexpr int bits = 8 * sizeof(Lane);
+        // 乘法至少在 32 位无符号里做：uint16_t 会提升成 int，65535 * 65535 溢出是未定义行为
+        using Wide = std::common_type_t<Lane, uint32_t>;
+
+        alignas(64) Lane regs[16][B];
+        alignas(64) Lane v1[B], v2[B];
+        // 污点按寄存器存成字节掩码，和寄存器走同样的选择/写回，SSE2 下没有逐 lane 的变量移位
+        alignas(64) uint8_t taint[16][B];
+        alignas(64) uint8_t t1[B], t2[B], diverged[B], jump[B];
+        alignas(64) uint8_t fetched[B], kind[B], math[B], op1[B], op2[B];
+        alignas(64) uint64_t state[B];
+        uint32_t pc[B];
+
+        for (size_t k = 0; k < B; ++k) {
+            ChaosEngine chaos(keys[k]);
+            for (int r = 0; r < 16; ++r) {
+                regs[r][k] = static_cast<Lane>(chaos.next_byte());
+                taint[r][k] = 0;
+            }
+            state[k] = chaos.raw_state();
+            diverged[k] = 0;
+            pc[k] = 0;
+        }
+
+        for (size_t step = 0; step < kSteps; ++step) {
+            // 取指：每个 lane 的 pc 和代码各不相同，只能逐个取
+            for (size_t k = 0; k < B; ++k) fetched[k] = code[k][pc[k]];
+
+            // 解码：Math 多消耗一个字节。每个 lane 都先走四步，再按 kind 挑选状态，这样不会产生分支
+            for (size_t k = 0; k < B; ++k) {
+                uint64_t x0 = ChaosEngine::advance(state[k]);
+                uint64_t x1 = ChaosEngine::advance(x0);
+                uint64_t x2 = ChaosEngine::advance(x1);
+                uint64_t x3 = ChaosEngine::advance(x2);
+                uint64_t kd = (fetched[k] ^ x0) & 3;
+                uint64_t m = mask_of<uint64_t>(kd == Math);
+                kind[k] = static_cast<uint8_t>(kd);
+                math[k] = static_cast<uint8_t>(x1 & m & 3);
+                op1[k] = static_cast<uint8_t>(blend(m, x2, x1) & 15);
+                op2[k] = static_cast<uint8_t>(blend(m, x3, x2) & 15);
+                state[k] = blend(m, x3, x2);
+            }
+
+            // 按寄存器号选取操作数和它们的污点
+            for (size_t k = 0; k < B; ++k) { v1[k] = 0; v2[k] = 0; t1[k] = 0; t2[k] = 0; }
+            for (uint8_t r = 0; r < 16; ++r) {
+                for (size_t k = 0; k < B; ++k) {
+                    Lane s1 = mask_of<Lane>(op1[k] == r), s2 = mask_of<Lane>(op2[k] == r);
+                    v1[k] |= regs[r][k] & s1;
+                    v2[k] |= regs[r][k] & s2;
+                    t1[k] |= taint[r][k] & static_cast<uint8_t>(s1);
+                    t2[k] |= taint[r][k] & static_cast<uint8_t>(s2);
+                }
+            }
+
+            // 算出要写回 op1 的值和污点：Math 是两个操作数的并，Mov 只看 op2；
+            // 跳转读到有污点的寄存器时，这个 lane 的 pc 从此不可信
+            for (size_t k = 0; k < B; ++k) {
+                Lane a = v1[k], b = v2[k];
+                Lane m = blend(mask_of<Lane>(math[k] == 0), static_cast<Lane>(a + b), static_cast<Lane>(0));
+                m |= blend(mask_of<Lane>(math[k] == 1), static_cast<Lane>(a - b), static_cast<Lane>(0));
+                m |= blend(mask_of<Lane>(math[k] == 2), static_cast<Lane>(a ^ b), static_cast<Lane>(0));
+                m |= blend(mask_of<Lane>(math[k] == 3), static_cast<Lane>(static_cast<Wide>(a) * static_cast<Wide>(b | 1)), static_cast<Lane>(0));
+                uint8_t is_math = mask_of<uint8_t>(kind[k] == Math);
+                uint8_t is_jmp = mask_of<uint8_t>(kind[k] == Jmp);
+                v1[k] = blend(mask_of<Lane>(kind[k] == Math), m, b);
+                t2[k] = static_cast<uint8_t>(t2[k] | (t1[k] & is_math));
+                diverged[k] |= t1[k] & is_jmp;
+                jump[k] = static_cast<uint8_t>(a & 0x1F & is_jmp);
+            }
+
+            // 写回：Math/Mov 写 op1，其余指令保持原值
+            for (uint8_t r = 0; r < 16; ++r) {
+                for (size_t k = 0; k < B; ++k) {
+                    Lane w = mask_of<Lane>((op1[k] == r) & (kind[k] <= Mov));
+                    regs[r][k] = blend(w, v1[k], regs[r][k]);
+                    taint[r][k] = blend(static_cast<uint8_t>(w), t2[k], taint[r][k]);
+                }
+            }
+
+            // 窄 lane 里 rotl 拿不到高位，R0 整体标记为可能错误
+            for (size_t k = 0; k < B; ++k) {
+                Lane r0 = regs[0][k];
+                Lane rot = static_cast<Lane>((r0 << 3) | (r0 >> (bits - 3)));
+                Lane sys = mask_of<Lane>(kind[k] == Sys);
+                regs[0][k] = blend(sys, rot, r0);
+                if constexpr (!full) taint[0][k] |= static_cast<uint8_t>(sys);
+            }
+
+            // 每步最多前进 32，只在越过代码末尾时才做一次取模
+            for (size_t k = 0; k < B; ++k) {
+                uint32_t p = pc[k] + jump[k] + 1;
+                uint32_t n = static_cast<uint32_t>(code[k].size());
+                pc[k] = p >= n ? p % n : p;
+            }
+        }
+
+        BatchResult<Lane, B> r;
+        for (size_t k = 0; k < B; ++k) {
+            uint8_t bad = diverged[k];
+            for (size_t i = 0; i < out_len && i < 16; ++i) bad |= taint[i][k];
+            for (int i = 0; i < 16; ++i) r.low[k][i] = static_cast<uint8_t>(regs[i][k]);
+            r.exact[k] = !bad;
+        }
+        return r;
+    }
+
+    // 任意数量的 Key：按 B 个一批窄求值，不精确的 lane 回退到参考求值器
+    // 返回每个 Key 最终寄存器的低 8 位；fallbacks 记录回退次数
+    template <typename Lane, size_t B>
+    std::vector<std::array<uint8_t, 16>> evaluate_all(std::span<const std::string_view> keys,
+        std::span<const std::span<const uint8_t>> code, size_t out_len, size_t* fallbacks = nullptr)
+    {
+        std::vector<std::array<uint8_t, 16>> out(keys.size());
+        size_t slow = 0;
+        for (size_t base = 0; base < keys.size(); base += B) {
+            std::array<std::string_view, B> k{};
+            std::array<std::span<const uint8_t>, B> c{};
+            size_t n = keys.size() - base < B ? keys.size() - base : B;
+            for (size_t i = 0; i < B; ++i) {
+                // 尾批用第一个 Key 填满，结果丢弃
+                size_t src = base + (i < n ? i : 0);
+                k[i] = keys[src];
+                c[i] = code[code.size() == 1 ? 0 : src];
+            }
+
+            auto r = evaluate_batch<Lane, B>(k, c, out_len);
+            for (size_t i = 0; i < n; ++i) {
+                if (r.exact[i]) {
+                    out[base + i] = r.low[i];
+                    continue;
+                }
+                Trace t = reference(k[i], c[i]);
+                for (int j = 0; j < 16; ++j) out[base + i][j] = static_cast<uint8_t>(t.final_regs[j]);
+                ++slow;
+            }
+        }
+        if (fallbacks) *fallbacks = slow;
+        return out;
+    }
+}
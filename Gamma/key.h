@@ -1,5 +1,27 @@
 ﻿// ============ PASTE KEYGEN OUTPUT HERE ============
-// 示例数据 (必须用 Keygen 生成覆盖这里)
-std::vector<uint8_t> encrypted_code = { /* ... */ };
-std::vector<uint8_t> secret_cipher = { /* ... */ };
+// 示例数据: Gamma_keygen 以 Key "Gamma-Sample-Key" 生成, 发布前用自己的 Key 重新生成覆盖这里
+constexpr std::array<uint8_t, 256> encrypted_code = {
+    0xf3, 0x0f, 0x03, 0x3c, 0xd1, 0x74, 0x12, 0xce, 0xa3, 0x18, 0xca, 0x29, 0x51, 0xd0, 0xd7, 0x59,
+    0x70, 0xe2, 0x1c, 0x88, 0x88, 0xe2, 0x60, 0x0f, 0xfb, 0x93, 0xb3, 0x96, 0x2a, 0x70, 0x0d, 0x19,
+    0x4e, 0xd9, 0x16, 0x52, 0x56, 0xa2, 0xbc, 0x15, 0xa1, 0x54, 0xc6, 0xe8, 0xb1, 0x23, 0x0c, 0xd5,
+    0x2d, 0xf3, 0xe4, 0xd1, 0xd3, 0x08, 0x76, 0x52, 0xe7, 0x7a, 0x65, 0xd7, 0x7c, 0x4d, 0xde, 0x09,
+    0x55, 0x3c, 0x7c, 0x6e, 0x98, 0xf0, 0x2b, 0x58, 0xf9, 0x08, 0x6b, 0xfb, 0x79, 0x78, 0x08, 0x8f,
+    0xb9, 0xf4, 0xb8, 0xdb, 0x04, 0xae, 0xbf, 0xec, 0x07, 0x66, 0x89, 0xb1, 0xb3, 0xf6, 0x49, 0xf0,
+    0xba, 0xff, 0xc4, 0xa3, 0xbc, 0xa3, 0x62, 0xd0, 0xd2, 0x33, 0xe5, 0x99, 0x6d, 0x89, 0xa8, 0x6a,
+    0x2a, 0xa2, 0x4a, 0x16, 0x39, 0x30, 0x5f, 0xae, 0xb0, 0x3a, 0xed, 0x86, 0x8b, 0xeb, 0xb9, 0x57,
+    0xa6, 0xd8, 0x7e, 0x75, 0xbf, 0x73, 0x34, 0xb0, 0x5a, 0xa1, 0xe3, 0x0f, 0xcf, 0x59, 0x2d, 0x62,
+    0x1f, 0xad, 0x82, 0xed, 0xba, 0x58, 0x1e, 0x24, 0x17, 0xb8, 0xa2, 0x97, 0x90, 0xd4, 0x40, 0x1a,
+    0x29, 0x34, 0x4d, 0x96, 0xba, 0x4a, 0xd6, 0x0b, 0xb9, 0x28, 0xeb, 0x10, 0x99, 0x44, 0x02, 0xe7,
+    0x5c, 0x6b, 0x55, 0x83, 0x99, 0xc5, 0x96, 0xaf, 0xb0, 0xa3, 0x0f, 0x7b, 0xba, 0xb8, 0x39, 0x79,
+    0x9b, 0x8a, 0x47, 0x21, 0x39, 0xb9, 0x50, 0x11, 0xe1, 0xdb, 0xfb, 0x75, 0xda, 0x29, 0x8a, 0x81,
+    0x79, 0x8e, 0x82, 0xac, 0x82, 0xe3, 0xb7, 0x8b, 0xac, 0xfa, 0x70, 0x87, 0x83, 0x0a, 0x9b, 0xa8,
+    0x83, 0x31, 0xaf, 0x55, 0xa0, 0xc0, 0x43, 0x2c, 0xd5, 0x3e, 0x69, 0xfa, 0x2d, 0x26, 0x62, 0xe9,
+    0x25, 0x60, 0x92, 0x27, 0x9e, 0x88, 0x94, 0x92, 0x79, 0x9d, 0x46, 0x17, 0x6d, 0xb9, 0x41, 0xbb,
+};
+
+constexpr std::array<uint8_t, 45> secret_cipher = {
+    0x52, 0x7e, 0x7f, 0x76, 0x63, 0x70, 0x65, 0x64, 0x7d, 0x70, 0x65, 0x78, 0x7e, 0x7f, 0x62, 0x30,
+    0x31, 0x45, 0x79, 0x74, 0x31, 0x56, 0x70, 0x7c, 0x7c, 0x70, 0x31, 0x72, 0x7e, 0x63, 0x74, 0x31,
+    0x78, 0x62, 0x31, 0x75, 0x78, 0x62, 0x62, 0x7e, 0x7d, 0x67, 0x74, 0x75, 0x3f,
+};
 // ==================================================
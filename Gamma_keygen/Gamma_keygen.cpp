@@ -1,82 +1,98 @@
 ﻿#include <iostream>
+#include <fstream>
 #include <vector>
 #include <array>
+#include <string>
+#include <string_view>
 #include <iomanip>
 #include <bit>
-#include "..\Gamma\Common.h"
+#include <charconv>
+#include "Keygen.h"
+
+// 我们希望最终解密出这句话：
+constexpr std::string_view kPlaintext = "Congratulations! The Gamma core is dissolved.";
+
+// 批量模式：Gamma_keygen --bulk <keys.txt|-> <out.bin> [threads]
+// keys.txt 每行一个客户 Key，输出为 Keygen.h 中定义的二进制记录
+int bulk(int argc, char** argv) {
+    auto usage = [] {
+        std::cout << "usage: Gamma_keygen --bulk <keys.txt|-> <out.bin> [threads]\n";
+        return 1;
+    };
+    if (argc < 4) return usage();
+    std::string_view src = argv[2];
+    unsigned threads = 0;
+    if (argc > 4) {
+        std::string_view arg = argv[4];
+        auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), threads);
+        if (ec != std::errc{} || end != arg.data() + arg.size()) return usage();
+    }
+
+    std::vector<std::string> keys;
+    std::ifstream file;
+    if (src != "-") {
+        file.open(argv[2]);
+        if (!file) {
+            std::cout << "[-] cannot read " << src << "\n";
+            return 1;
+        }
+    }
+    std::istream& in = src == "-" ? std::cin : file;
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) keys.push_back(std::move(line));
+    }
+
+    if (keys.empty()) {
+        std::cout << "[-] no keys in " << src << "\n";
+        return 1;
+    }
+
+    auto st = Keygen::issue_bulk(keys, kPlaintext, argv[3], threads);
+    if (!st.ok) {
+        std::cout << "[-] failed to write " << argv[3] << "\n";
+        return 1;
+    }
+
+    if (st.rejected) std::cout << "[!] " << st.rejected << " keys longer than " << Keygen::kMaxKey << " bytes skipped\n";
+    std::cout << "[+] " << st.programs << " programs, " << st.bytes << " bytes, " << st.threads << " threads\n";
+    if (!st.programs || st.seconds <= 0) return st.programs ? 0 : 1;
+    std::cout << "    " << std::fixed << std::setprecision(0) << st.programs / st.seconds << " programs/sec, "
+        << std::setprecision(1) << st.bytes / st.seconds / (1 << 20) << " MiB/s\n";
+    std::cout << "    " << st.gen_ns_per_program << " ns per program (generation latency, measured per batch)\n";
+    return 0;
+}
 
 // 模拟 GammaVM 的行为
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string_view(argv[1]) == "--bulk") return bulk(argc, argv);
+
     std::string key;
     std::cout << "Enter the password you want to use as the VALID KEY: ";
     std::getline(std::cin, key);
 
     if (key.empty()) key = "1234";
 
-    ChaosEngine chaos(key);
-
-    // 1. 初始化模拟寄存器
-    std::array<uint64_t, 16> regs = { 0 };
-    for (auto& r : regs) r = chaos.next_byte();
-
-    std::vector<uint8_t> final_code_blob;
-
-    // 2. 模拟运行 256 步，并生成对应的字节码
-    // 我们的策略：强制生成 'InstMov' (Type 1) 指令。
-    // 因为 MOV 是确定性的，不会产生复杂的数学爆炸，便于我们预测最终状态。
-    // InstMov 对应 switch(op % 4) == 1。所以我们需要 op = 1 (或者 5, 9...)
-
     std::cout << "\n[+] Simulating VM execution and generating bytecode...\n";
-
-    for (int step = 0; step < 256; ++step) {
-        // --- 模拟 VM 的取指阶段 ---
-        uint8_t decrypt_mask = chaos.next_byte();
-
-        // 我们希望解密出来的 op 是 0x01 (InstMov)
-        // 因为: op = raw ^ mask
-        // 所以: raw = op ^ mask
-        uint8_t target_op = 0x01;
-        uint8_t raw_byte = target_op ^ decrypt_mask;
-
-        final_code_blob.push_back(raw_byte);
-
-        // --- 模拟 VM 的操作数读取 ---
-        uint8_t op1_idx = chaos.next_byte() % 16;
-        uint8_t op2_idx = chaos.next_byte() % 16;
-
-        // --- 模拟 VM 的执行 (InstMov) ---
-        // 必须和 CrackMe 里的 InstMov 逻辑一模一样
-        regs[op1_idx] = regs[op2_idx];
-    }
-
-    // 3. 计算最终的校验密文
-    // 我们希望最终解密出这句话：
-    std::string plaintext = "Congratulations! The Gamma core is dissolved.";
-    std::vector<uint8_t> cipher_blob;
-
-    for (size_t i = 0; i < plaintext.size(); ++i) {
-        // Gamma 逻辑： plain = cipher ^ reg
-        // 所以： cipher = plain ^ reg
-        char k = static_cast<char>(regs[i % 16] & 0xFF);
-        cipher_blob.push_back(plaintext[i] ^ k);
-    }
+    Keygen::Image img = Keygen::generate(key, kPlaintext);
 
     // 4. 输出 C++ 代码块
     std::cout << "\n// ============ COPY BELOW TO CRACKME_GAMMA KEY.H ============\n";
 
     // 输出 encrypted_code
-    std::cout << "std::vector<uint8_t> encrypted_code = {";
-    for (size_t i = 0; i < final_code_blob.size(); ++i) {
+    // constexpr std::array 放在只读段里，CrackMe 启动时没有静态构造，也不会分配堆
+    std::cout << "constexpr std::array<uint8_t, " << img.code.size() << "> encrypted_code = {";
+    for (size_t i = 0; i < img.code.size(); ++i) {
         if (i % 16 == 0) std::cout << "\n    ";
-        std::cout << "0x" << std::hex << std::setw(2) << std::setfill('0') << (int)final_code_blob[i] << ", ";
+        std::cout << "0x" << std::hex << std::setw(2) << std::setfill('0') << (int)img.code[i] << ", ";
     }
     std::cout << "\n};\n\n";
 
     // 输出 secret_data (在 CrackMe 里替换那个 XStr 或者直接用 byte array)
-    std::cout << "std::vector<uint8_t> secret_cipher = {";
-    for (size_t i = 0; i < cipher_blob.size(); ++i) {
+    std::cout << "constexpr std::array<uint8_t, " << std::dec << img.cipher.size() << "> secret_cipher = {";
+    for (size_t i = 0; i < img.cipher.size(); ++i) {
         if (i % 16 == 0) std::cout << "\n    ";
-        std::cout << "0x" << std::hex << std::setw(2) << std::setfill('0') << (int)cipher_blob[i] << ", ";
+        std::cout << "0x" << std::hex << std::setw(2) << std::setfill('0') << (int)img.cipher[i] << ", ";
     }
     std::cout << "\n};\n";
     std::cout << "// =========================================================\n";
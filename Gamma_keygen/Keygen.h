@@ -0,0 +1,197 @@
+﻿#pragma once
+#include <vector>
+#include <array>
+#include <string>
+#include <string_view>
+#include <span>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include "../Gamma/Common.h"
+
+// ==========================================
+// Gamma 注册机库
+// generate(key, plaintext) 模拟 GammaVM 的执行，产出对应的程序镜像
+// ==========================================
+namespace Keygen {
+    constexpr size_t kSteps = 256; // 必须和 GammaVM::run 一致
+
+    struct Image {
+        std::vector<uint8_t> code;   // encrypted_code
+        std::vector<uint8_t> cipher; // secret_cipher
+    };
+
+    // 不分配内存的版本：code 必须有 kSteps 字节，cipher 必须有 plaintext.size() 字节
+    inline void generate_into(std::string_view key, std::string_view plaintext, uint8_t* code, uint8_t* cipher) {
+        ChaosEngine chaos(key);
+
+        // 1. 初始化模拟寄存器
+        std::array<uint64_t, 16> regs = { 0 };
+        for (auto& r : regs) r = chaos.next_byte();
+
+        // 2. 模拟运行 256 步，并生成对应的字节码
+        // 我们的策略：强制生成 'InstMov' (Type 1) 指令。
+        // 因为 MOV 是确定性的，不会产生复杂的数学爆炸，便于我们预测最终状态。
+        for (size_t step = 0; step < kSteps; ++step) {
+            // 我们希望解密出来的 op 是 0x01 (InstMov)：raw = op ^ mask
+            uint8_t decrypt_mask = chaos.next_byte();
+            code[step] = 0x01 ^ decrypt_mask;
+
+            uint8_t op1_idx = chaos.next_byte() % 16;
+            uint8_t op2_idx = chaos.next_byte() % 16;
+            regs[op1_idx] = regs[op2_idx];
+        }
+
+        // 3. 计算最终的校验密文：cipher = plain ^ reg
+        for (size_t i = 0; i < plaintext.size(); ++i) {
+            cipher[i] = static_cast<uint8_t>(plaintext[i] ^ static_cast<char>(regs[i % 16] & 0xFF));
+        }
+    }
+
+    inline Image generate(std::string_view key, std::string_view plaintext) {
+        Image img;
+        img.code.resize(kSteps);
+        img.cipher.resize(plaintext.size());
+        generate_into(key, plaintext, img.code.data(), img.cipher.data());
+        return img;
+    }
+
+    // ==========================================
+    // 二进制记录格式（小端）：
+    //   RecordHeader | key | code[code_len] | cipher[cipher_len]
+    // ==========================================
+    constexpr uint32_t kRecordMagic = 0x3159474B; // "KGY1"
+
+    struct RecordHeader {
+        uint32_t magic;
+        uint16_t key_len;
+        uint16_t code_len;
+        uint32_t cipher_len;
+    };
+    static_assert(sizeof(RecordHeader) == 12);
+
+    constexpr size_t kMaxKey = UINT16_MAX; // RecordHeader::key_len 只有 16 位
+
+    // Key 放不进记录头时返回 0，这条记录整个跳过
+    inline size_t record_size(std::string_view key, std::string_view plaintext) {
+        if (key.size() > kMaxKey) return 0;
+        return sizeof(RecordHeader) + key.size() + kSteps + plaintext.size();
+    }
+
+    // 返回写入的字节数，总是等于 record_size()；跳过的记录什么也不写
+    inline size_t write_record(uint8_t* out, std::string_view key, std::string_view plaintext) {
+        size_t size = record_size(key, plaintext);
+        if (!size) return 0;
+        RecordHeader h{ kRecordMagic, static_cast<uint16_t>(key.size()), static_cast<uint16_t>(kSteps), static_cast<uint32_t>(plaintext.size()) };
+        uint8_t* p = out;
+        std::memcpy(p, &h, sizeof(h));
+        p += sizeof(h);
+        std::memcpy(p, key.data(), key.size());
+        p += key.size();
+        generate_into(key, plaintext, p, p + kSteps);
+        return size;
+    }
+
+    // ==========================================
+    // 批量签发：所有核心并行生成，主线程按输入顺序大块写入同一个文件
+    // ==========================================
+    struct BulkStats {
+        size_t programs = 0;
+        size_t rejected = 0;  // Key 超过 kMaxKey 被跳过的条数
+        size_t bytes = 0;
+        double seconds = 0;
+        double gen_ns_per_program = 0; // 每条记录的平均生成耗时（按批计时，含线程被抢占的时间）
+        unsigned threads = 0;
+        bool ok = false;
+    };
+
+    inline BulkStats issue_bulk(std::span<const std::string> keys, std::string_view plaintext, const char* path, unsigned threads = 0) {
+        constexpr size_t kBatch = 2048;   // 每批记录数
+        constexpr size_t kWindow = 64;    // 最多领先写入端多少批，限制内存
+        constexpr size_t kFileBuffer = 8 << 20;
+
+        BulkStats st;
+        st.threads = threads ? threads : (std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1);
+
+        std::FILE* out = std::fopen(path, "wb");
+        if (!out) return st;
+        std::vector<char> iobuf(kFileBuffer);
+        std::setvbuf(out, iobuf.data(), _IOFBF, iobuf.size());
+
+        struct Batch {
+            std::vector<uint8_t> data;
+            std::atomic<bool> ready{ false };
+            int64_t gen_ns = 0;
+            size_t rejected = 0;
+        };
+        size_t batch_count = (keys.size() + kBatch - 1) / kBatch;
+        auto batches = std::make_unique<Batch[]>(batch_count);
+
+        std::atomic<size_t> next{ 0 };
+        std::atomic<size_t> written{ 0 };
+
+        auto make_batch = [&](size_t b) {
+            auto t0 = std::chrono::steady_clock::now();
+            size_t lo = b * kBatch;
+            size_t hi = lo + kBatch < keys.size() ? lo + kBatch : keys.size();
+            Batch& batch = batches[b];
+            size_t bytes = 0;
+            for (size_t i = lo; i < hi; ++i) {
+                size_t n = record_size(keys[i], plaintext);
+                bytes += n;
+                batch.rejected += n == 0;
+            }
+
+            batch.data.resize(bytes);
+            uint8_t* p = batch.data.data();
+            for (size_t i = lo; i < hi; ++i) p += write_record(p, keys[i], plaintext);
+            batch.gen_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+
+            batch.ready.store(true, std::memory_order_release);
+            batch.ready.notify_one();
+        };
+
+        auto worker = [&] {
+            while (true) {
+                size_t b = next.fetch_add(1);
+                if (b >= batch_count) return;
+
+                // 领先太多就等写入端追上
+                for (size_t w = written.load(); b >= w + kWindow; w = written.load()) written.wait(w);
+                make_batch(b);
+            }
+        };
+
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<std::jthread> pool;
+        for (unsigned i = 1; i < st.threads; ++i) pool.emplace_back(worker);
+
+        bool ok = true;
+        int64_t gen_ns = 0;
+        for (size_t b = 0; b < batch_count; ++b) {
+            Batch& batch = batches[b];
+            // 单线程时由写入端自己生成
+            if (st.threads == 1) make_batch(b);
+            batch.ready.wait(false, std::memory_order_acquire);
+            ok &= std::fwrite(batch.data.data(), 1, batch.data.size(), out) == batch.data.size();
+            st.bytes += batch.data.size();
+            gen_ns += batch.gen_ns;
+            st.rejected += batch.rejected;
+            std::vector<uint8_t>().swap(batch.data);
+            written.store(b + 1);
+            written.notify_all();
+        }
+        pool.clear();
+        ok &= std::fclose(out) == 0;
+
+        st.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        st.programs = keys.size() - st.rejected;
+        st.gen_ns_per_program = st.programs ? (double)gen_ns / st.programs : 0;
+        st.ok = ok;
+        return st;
+    }
+}
@@ -0,0 +1,62 @@
+﻿#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+
+// ==========================================
+// 冷启动模式：CrackMe 作为短命进程被反复拉起时，启动和退出的固定开销压过了 VM 本身
+// --fast-start 打开后：
+//   1. 守护线程推迟到真正开始执行 VM 时才创建（没有输入就根本不创建）
+//   2. 驱动协程时让出时间片而不是 sleep，sleep_for(1us) 在 Windows 上至少睡 1ms，在 Linux 上也要几十微秒
+// 无论哪种模式，守护线程都用可唤醒的等待代替 sleep，退出时不必再等满一个巡逻周期
+// ==========================================
+namespace FastStart {
+
+    inline bool requested(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            if (std::string_view(argv[i]) == "--fast-start") return true;
+        }
+        return false;
+    }
+
+    // 两次调用 resume() 之间的停顿
+    template <typename Rep, typename Period>
+    void pace(bool fast, std::chrono::duration<Rep, Period> d) {
+        if (fast) std::this_thread::yield();
+        else std::this_thread::sleep_for(d);
+    }
+
+    // 周期性执行 patrol() 的守护线程，start() 可以重复调用，只有第一次生效
+    class Sentry {
+        std::mutex m;
+        std::condition_variable_any cv;
+        std::jthread worker;
+
+    public:
+        template <typename F, typename Rep, typename Period>
+        void start(F patrol, std::chrono::duration<Rep, Period> interval) {
+            if (worker.joinable()) return;
+            worker = std::jthread([this, patrol, interval](std::stop_token st) {
+                std::unique_lock lock(m);
+                while (!st.stop_requested()) {
+                    lock.unlock();
+                    patrol();
+                    lock.lock();
+                    // stop 请求会直接唤醒这里
+                    cv.wait_for(lock, st, interval, [] { return false; });
+                }
+                });
+        }
+
+        void stop() {
+            if (!worker.joinable()) return;
+            worker.request_stop();
+            worker.join();
+        }
+
+        ~Sentry() { stop(); }
+    };
+}
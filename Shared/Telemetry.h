@@ -0,0 +1,150 @@
+﻿#pragma once
+#include <atomic>
+#include <array>
+#include <span>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ==========================================
+// 执行遥测：VM 线程 -> 巡逻线程的单生产者/单消费者事件流
+// 生产者只做普通存储，满了就丢弃，绝不阻塞解释器
+// ==========================================
+namespace Telemetry {
+
+    inline uint64_t read_tsc() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    // 16 字节，一条缓存行放 4 条
+    struct StepEvent {
+        uint32_t pc;
+        uint16_t opcode;
+        uint16_t reserved;
+        uint64_t tsc;
+    };
+
+    template <size_t N>
+    class SpscRing {
+        static_assert((N & (N - 1)) == 0, "capacity must be a power of two");
+
+        // 生产者和消费者各占一条缓存行，避免伪共享
+        alignas(64) std::atomic<uint64_t> head{ 0 };
+        uint64_t tail_cache = 0;
+        std::atomic<uint64_t> dropped{ 0 };
+
+        alignas(64) std::atomic<uint64_t> tail{ 0 };
+
+        alignas(64) std::array<StepEvent, N> buf{};
+
+    public:
+        // 只能由唯一的生产者线程调用
+        // head 用 release 发布：x86 上与 relaxed 一样是一条普通 mov
+        bool push(const StepEvent& e) {
+            uint64_t h = head.load(std::memory_order_relaxed);
+            if (h - tail_cache == N) {
+                tail_cache = tail.load(std::memory_order_acquire);
+                if (h - tail_cache == N) {
+                    dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+            buf[h & (N - 1)] = e;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 只能由唯一的消费者线程调用；一次取走当前所有事件
+        // 环形缓冲区回绕时 f 会被调用两次，每次拿到一段连续的 span
+        template <typename F>
+        size_t drain(F&& f) {
+            uint64_t t = tail.load(std::memory_order_relaxed);
+            uint64_t h = head.load(std::memory_order_acquire);
+            if (h == t) return 0;
+
+            size_t begin = t & (N - 1);
+            size_t count = h - t;
+            size_t first = count < N - begin ? count : N - begin;
+            f(std::span<const StepEvent>(buf.data() + begin, first));
+            if (first < count) f(std::span<const StepEvent>(buf.data(), count - first));
+
+            tail.store(h, std::memory_order_release);
+            return count;
+        }
+
+        uint64_t dropped_count() const { return dropped.load(std::memory_order_relaxed); }
+        static constexpr size_t capacity() { return N; }
+    };
+
+    // ==========================================
+    // 消费端：实时异常检测
+    // TSC 频率未知，借巡逻线程每次醒来的墙钟时间顺手校准
+    // ==========================================
+    class StepMonitor {
+        uint64_t gap_limit_ns;
+        int64_t calib_ns = 0;
+        uint64_t calib_tsc = 0;
+        uint64_t gap_limit_ticks = 0; // 0 表示尚未校准
+
+        uint64_t last_tsc = 0;
+
+    public:
+        uint64_t events = 0;
+        uint64_t anomalies = 0;
+        uint64_t max_gap_ticks = 0;
+        uint32_t last_anomaly_pc = 0;
+        std::array<uint64_t, 16> opcode_hist{};
+
+        constexpr explicit StepMonitor(uint64_t gap_limit_ns) : gap_limit_ns(gap_limit_ns) {}
+
+        void tick(int64_t now_ns, uint64_t now_tsc) {
+            if (calib_ns == 0) {
+                calib_ns = now_ns;
+                calib_tsc = now_tsc;
+                return;
+            }
+            int64_t dt = now_ns - calib_ns;
+            if (dt < 10'000'000 || now_tsc <= calib_tsc) return;
+            double ticks_per_ns = (double)(now_tsc - calib_tsc) / (double)dt;
+            gap_limit_ticks = (uint64_t)(ticks_per_ns * (double)gap_limit_ns);
+        }
+
+        // 返回这一批里新发现的异常数
+        uint64_t observe(std::span<const StepEvent> batch) {
+            uint64_t found = 0;
+            for (const auto& e : batch) {
+                if (last_tsc != 0 && e.tsc > last_tsc) {
+                    uint64_t gap = e.tsc - last_tsc;
+                    if (gap > max_gap_ticks) max_gap_ticks = gap;
+                    if (gap_limit_ticks != 0 && gap > gap_limit_ticks) {
+                        ++found;
+                        last_anomaly_pc = e.pc;
+                    }
+                }
+                last_tsc = e.tsc;
+                ++opcode_hist[e.opcode & 15];
+            }
+            events += batch.size();
+            anomalies += found;
+            return found;
+        }
+    };
+
+    // 导出：每行 pc,opcode,tsc
+    inline void export_csv(std::FILE* out, std::span<const StepEvent> batch) {
+        for (const auto& e : batch) {
+            std::fprintf(out, "%u,%u,%llu\n", e.pc, e.opcode, (unsigned long long)e.tsc);
+        }
+    }
+}
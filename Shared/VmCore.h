@@ -0,0 +1,274 @@
+﻿#pragma once
+#include <array>
+#include <string>
+#include <variant>
+#include <coroutine>
+#include <chrono>
+#include <exception>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "Telemetry.h"
+
+// ==========================================
+// 三个 CrackMe 共用的 VM 骨架
+// 取指 -> 反调试检查 -> 分派 -> 分支 -> 调度，每一环都是编译期的策略，
+// 每个二进制挑自己的组合，策略之间没有虚函数，也不保存多余状态。
+//
+// Machine 需要提供：
+//   bool done(size_t pc)                  是否结束（可以顺便处理错误分支）
+//   decltype(auto) fetch(size_t pc)       取出一条 std::variant 指令
+//   Next operator()(const Op&, size_t pc) 每种指令的语义，返回 kNext 或跳转目标
+//   void tamper()                         内联检查发现调试器时调用
+//   void finish()                         跑完之后生成结果
+// ==========================================
+namespace VmCore {
+
+    // ==========================================
+    // 1. 编译期字符串加密
+    // 每个二进制用自己的 Key 和周期，密文和原来逐字节一致
+    // ==========================================
+    template <size_t N, uint8_t Key, size_t Period>
+    struct XStr {
+        std::array<char, N> buffer;
+
+        consteval XStr(const char(&str)[N]) : buffer{} {
+            for (size_t i = 0; i < N; ++i) buffer[i] = static_cast<char>(str[i] ^ Key ^ (i % Period));
+        }
+
+        // 运行时解密
+        std::string s() const {
+            std::string res(N, '\0');
+            for (size_t i = 0; i < N; ++i) res[i] = static_cast<char>(buffer[i] ^ Key ^ (i % Period));
+            return res.data(); // 去掉结尾的\0
+        }
+    };
+
+    // ==========================================
+    // 2. 协程任务
+    // 打破线性调用栈
+    // ==========================================
+    struct Task {
+        struct promise_type {
+            Task get_return_object() { return Task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+            std::suspend_always initial_suspend() { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); } // 这里的异常不应该逃逸
+            std::suspend_always yield_value(bool) { return {}; }
+        };
+
+        std::coroutine_handle<promise_type> h;
+        explicit Task(std::coroutine_handle<promise_type> h) : h(h) {}
+        Task(Task&& o) noexcept : h(std::exchange(o.h, {})) {}
+        Task& operator=(Task&& o) noexcept {
+            if (this != &o) {
+                if (h) h.destroy();
+                h = std::exchange(o.h, {});
+            }
+            return *this;
+        }
+        ~Task() { if (h) h.destroy(); }
+
+        void resume() { if (h && !h.done()) h.resume(); }
+        bool done() const { return !h || h.done(); }
+    };
+
+    // 指令语义的返回值：顺序执行，或者跳到某个绝对地址
+    using Next = size_t;
+    inline constexpr Next kNext = static_cast<Next>(-1);
+
+    // ==========================================
+    // 3. 分派策略
+    // ==========================================
+
+    // std::visit：编译器生成的跳转表，控制流最难看懂
+    struct Visit {
+        template <typename M, typename V>
+        static Next dispatch(M& m, const V& inst, size_t pc) {
+            return std::visit([&](const auto& op) { return m(op, pc); }, inst);
+        }
+    };
+
+    // 按 index() 展开成一串比较，交给编译器合并成 switch
+    struct Switch {
+        template <typename M, typename V, size_t... I>
+        static Next expand(M& m, const V& inst, size_t pc, std::index_sequence<I...>) {
+            Next next = kNext;
+            ((inst.index() == I ? (next = m(*std::get_if<I>(&inst), pc), true) : false) || ...);
+            return next;
+        }
+
+        template <typename M, typename V>
+        static Next dispatch(M& m, const V& inst, size_t pc) {
+            return expand(m, inst, pc, std::make_index_sequence<std::variant_size_v<V>>{});
+        }
+    };
+
+    // 调用线索化：每种指令一个处理函数，按 index() 查表间接调用
+    // MSVC 没有 computed goto，这是可移植的最接近直接线索化的形式
+    struct Threaded {
+        template <typename M, typename V, size_t I>
+        static Next thunk(M& m, const V& inst, size_t pc) {
+            return m(*std::get_if<I>(&inst), pc);
+        }
+
+        template <typename M, typename V, size_t... I>
+        static constexpr auto table(std::index_sequence<I...>) {
+            return std::array<Next(*)(M&, const V&, size_t), sizeof...(I)>{ &thunk<M, V, I>... };
+        }
+
+        template <typename M, typename V>
+        static Next dispatch(M& m, const V& inst, size_t pc) {
+            static constexpr auto handlers = table<M, V>(std::make_index_sequence<std::variant_size_v<V>>{});
+            return handlers[inst.index()](m, inst, pc);
+        }
+    };
+
+    // ==========================================
+    // 4. 反调试策略
+    // check() 返回 true 表示这一步发现了调试器
+    // ==========================================
+
+    struct NoCheck {
+        bool check(size_t, size_t) { return false; }
+    };
+
+    // 两条指令之间间隔超过 LimitMs，说明有人在单步调试
+    template <int64_t LimitMs>
+    struct InlineClock {
+        using clock = std::chrono::high_resolution_clock;
+        clock::time_point last = clock::now();
+
+        static bool expired(clock::time_point from, clock::time_point now) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(now - from).count() > LimitMs;
+        }
+
+        bool check(size_t, size_t) {
+            auto now = clock::now();
+            bool hit = expired(last, now);
+            last = now;
+            return hit;
+        }
+    };
+
+    // 同上，但上一条指令的时刻存在调用方那里（时钟计数），分几次驱动也连续
+    // 存 0 表示重新对时：下一条指令只记时刻、不判定
+    template <int64_t LimitMs>
+    struct InlineClockAt {
+        using clock = std::chrono::high_resolution_clock;
+        int64_t& last;
+
+        bool check(size_t, size_t) {
+            auto now = clock::now();
+            bool hit = last != 0 && InlineClock<LimitMs>::expired(clock::time_point(clock::duration(last)), now);
+            last = now.time_since_epoch().count();
+            return hit;
+        }
+    };
+
+    // 喂狗 + 把 (pc, opcode, tsc) 交给巡逻线程，判定和惩罚都在巡逻线程里
+    template <auto& Ring, void (*Feed)()>
+    struct Watchdog {
+        bool check(size_t pc, size_t opcode) {
+            Feed();
+            Ring.push({ static_cast<uint32_t>(pc), static_cast<uint16_t>(opcode), 0, Telemetry::read_tsc() });
+            return false;
+        }
+    };
+
+    // ==========================================
+    // 5. 分支策略
+    // ==========================================
+
+    // 跳转靠 throw/catch，静态 CFG 里看不到边
+    struct Exceptions {
+        struct Jump : std::exception {
+            size_t target;
+            explicit Jump(size_t target) : target(target) {}
+        };
+
+        [[noreturn]] static Next take(size_t target) { throw Jump(target); }
+
+        template <typename F>
+        static size_t step(size_t pc, F&& f) {
+            try {
+                Next next = f();
+                return next == kNext ? pc + 1 : next;
+            }
+            catch (const Jump& e) {
+                // 调试器在这里会很头疼，因为 "Next Instruction" 不在下一行
+                return e.target;
+            }
+        }
+    };
+
+    // 跳转目标作为返回值带回来
+    struct Values {
+        static constexpr Next take(size_t target) { return target; }
+
+        template <typename F>
+        static size_t step(size_t pc, F&& f) {
+            Next next = f();
+            return next == kNext ? pc + 1 : next;
+        }
+    };
+
+    // ==========================================
+    // 6. 调度策略：tick() 返回 true 时让出
+    // ==========================================
+
+    // 每 N 步挂起一次协程
+    template <unsigned N>
+    struct YieldEvery {
+        static_assert(N > 0);
+        unsigned left = N;
+
+        bool tick() {
+            if (--left) return false;
+            left = N;
+            return true;
+        }
+    };
+
+    // 一共只跑 left 步，给不用协程、由调用方分片驱动的场合，left 不能为 0
+    struct Budget {
+        size_t left;
+
+        bool tick() { return --left == 0; }
+    };
+
+    // ==========================================
+    // 7. 骨架
+    // ==========================================
+    template <typename Dispatch, typename AntiDebug, typename Branch, typename Schedule>
+    struct Core {
+        using branch = Branch;
+
+        // 从 pc 跑到结束或调度器要求让出，返回 true 表示是让出的
+        template <typename M>
+        static bool slice(M& m, AntiDebug& guard, Schedule& sched, size_t& pc) {
+            while (!m.done(pc)) {
+                decltype(auto) inst = m.fetch(pc);
+                if (guard.check(pc, inst.index())) m.tamper();
+
+                pc = Branch::step(pc, [&] { return Dispatch::dispatch(m, inst, pc); });
+
+                if (sched.tick()) return true;
+            }
+            return false;
+        }
+
+        template <typename M>
+        static Task run(M& m) {
+            AntiDebug guard;
+            Schedule sched;
+            size_t pc = 0;
+
+            // 协程挂起，切碎栈帧
+            while (slice(m, guard, sched, pc)) co_yield true;
+
+            m.finish();
+        }
+    };
+}
@@ -0,0 +1,833 @@
+﻿#include <iostream>
+#include <vector>
+#include <array>
+#include <string>
+#include <variant>
+#include <bitset>
+#include <chrono>
+#include <random>
+#include <bit>
+#include <algorithm>
+#include <span>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "../Alpha/Common.h"
+#include "../Beta/Common.h"
+
+// ==========================================
+// 1. 统一的约束 IR
+// Alpha/Beta 的指令都能翻译成这几种步骤
+// ==========================================
+struct Step {
+    enum Kind : uint8_t { LoadImm, LoadInput, Add, Xor, Mul, MulImm, AndImm, Rol, Assert } kind;
+    int dst;
+    int src;       // 寄存器 / 输入下标
+    uint64_t imm;  // 立即数 / 移位量 / 期望值 / 是否符号扩展
+};
+
+struct Program {
+    std::vector<Step> steps;
+    int reg_count = 8;
+    int input_len = 0;
+};
+
+// Alpha：OpCheck 只覆盖 flag_zero，真正决定成败的只有最后一条非累积检查
+// 以及它之后所有 accumulate 的 OpVecCheck
+// 向量寄存器按字节拆成 R8 起的 4x32 个标量寄存器，每条向量指令展开成逐字节的 mod 256 运算
+Program lower(const Alpha::Bytecode& program) {
+    const auto& code = program.code;
+    constexpr int kLaneBase = 8;
+    constexpr int kScratch = kLaneBase + Alpha::kVecRegs * (int)Alpha::kVecWidth;
+
+    Program p;
+    p.reg_count = kScratch + 1;
+
+    size_t last_check = code.size();
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (std::holds_alternative<Alpha::OpCheck>(code[i])) last_check = i;
+        if (auto* vc = std::get_if<Alpha::OpVecCheck>(&code[i]); vc && !vc->accumulate) last_check = i;
+    }
+    auto lane = [](int vreg, size_t l) { return kLaneBase + vreg * (int)Alpha::kVecWidth + (int)l; };
+    auto lanewise = [&](int vreg, const Alpha::VecBytes& imm, Step::Kind k) {
+        for (size_t l = 0; l < Alpha::kVecWidth; ++l) {
+            if (k == Step::MulImm) {
+                p.steps.push_back({ Step::MulImm, lane(vreg, l), 0, imm[l] });
+            }
+            else {
+                p.steps.push_back({ Step::LoadImm, kScratch, 0, imm[l] });
+                p.steps.push_back({ k, lane(vreg, l), kScratch, 0 });
+            }
+            if (k != Step::Xor) p.steps.push_back({ Step::AndImm, lane(vreg, l), 0, 0xFF });
+        }
+    };
+
+    for (size_t i = 0; i < code.size(); ++i) {
+        std::visit([&](auto&& arg) {
+            using T = std::decay_t<decltype(arg)>;
+            if constexpr (std::is_same_v<T, Alpha::OpLoadImm>) {
+                p.steps.push_back({ Step::LoadImm, arg.reg_idx, 0, (uint64_t)arg.value });
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpLoadInput>) {
+                p.steps.push_back({ Step::LoadInput, arg.reg_idx, arg.input_idx, 0 });
+                p.input_len = std::max(p.input_len, arg.input_idx + 1);
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpAdd>) {
+                p.steps.push_back({ Step::Add, arg.dest, arg.src, 0 });
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpXor>) {
+                p.steps.push_back({ Step::Xor, arg.dest, arg.src, 0 });
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpMul>) {
+                p.steps.push_back({ Step::Mul, arg.dest, arg.src, 0 });
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpCheck>) {
+                if (i == last_check)
+                    p.steps.push_back({ Step::Assert, arg.reg_idx, 0, (uint64_t)arg.expected });
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpVecLoad>) {
+                // 越界的字节在 VM 里读作 0，这里仍当作未知输入，解出 0 即表示 Key 可以更短
+                for (size_t l = 0; l < Alpha::kVecWidth; ++l)
+                    p.steps.push_back({ Step::LoadInput, lane(arg.vreg, l), arg.input_idx + (int)l, 0 });
+                p.input_len = std::max(p.input_len, arg.input_idx + (int)Alpha::kVecWidth);
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpVecAdd>) {
+                lanewise(arg.vreg, program.pool[arg.imm], Step::Add);
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpVecXor>) {
+                lanewise(arg.vreg, program.pool[arg.imm], Step::Xor);
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpVecMul>) {
+                lanewise(arg.vreg, program.pool[arg.imm], Step::MulImm);
+            }
+            else if constexpr (std::is_same_v<T, Alpha::OpVecCheck>) {
+                if (i < last_check) return;
+                if (i > last_check || last_check == code.size()) {
+                    if (!arg.accumulate) return;
+                    if (last_check == code.size()) {
+                        // flag_zero 初值为 false，没有前置检查的累积检查永远失败
+                        p.steps.push_back({ Step::LoadImm, kScratch, 0, 0 });
+                        p.steps.push_back({ Step::Assert, kScratch, 0, 1 });
+                        return;
+                    }
+                }
+                const auto& expected = program.pool[arg.expected];
+                for (size_t l = 0; l < (size_t)arg.lanes && l < Alpha::kVecWidth; ++l)
+                    p.steps.push_back({ Step::Assert, lane(arg.vreg, l), 0, expected[l] });
+            }
+            }, code[i]);
+    }
+    return p;
+}
+
+// Beta：所有断言都必须成立，否则就跳进 999 错误分支
+// OpLoadByte 读的是 char，高位字节会被符号扩展
+Program lower(const std::vector<Beta::Instruction>& code) {
+    Program p;
+    for (const auto& inst : code) {
+        std::visit([&](auto&& arg) {
+            using T = std::decay_t<decltype(arg)>;
+            if constexpr (std::is_same_v<T, Beta::OpLoadByte>) {
+                p.steps.push_back({ Step::LoadInput, arg.reg, (int)arg.idx, 1 });
+                p.input_len = std::max(p.input_len, (int)arg.idx + 1);
+            }
+            else if constexpr (std::is_same_v<T, Beta::OpAdd>) {
+                p.steps.push_back({ Step::Add, arg.r1, arg.r2, 0 });
+            }
+            else if constexpr (std::is_same_v<T, Beta::OpXor>) {
+                p.steps.push_back({ Step::Xor, arg.r1, arg.r2, 0 });
+            }
+            else if constexpr (std::is_same_v<T, Beta::OpRol>) {
+                p.steps.push_back({ Step::Rol, arg.r1, 0, (uint64_t)arg.shift });
+            }
+            else if constexpr (std::is_same_v<T, Beta::OpAssertEq>) {
+                p.steps.push_back({ Step::Assert, arg.r1, 0, arg.val });
+            }
+            }, inst);
+    }
+    return p;
+}
+
+// std::bitset 没有标准的 find_first
+int lowest(const std::bitset<256>& b) {
+    for (int v = 0; v < 256; ++v) if (b[v]) return v;
+    return -1;
+}
+
+// ==========================================
+// 2. 逆向求解器
+// 正向建立表达式 DAG，遇到断言时从期望值往回逐条求逆
+// ==========================================
+class Inverter {
+public:
+    // 超出预算没能消解的约束
+    struct Residual {
+        std::vector<int32_t> bytes;
+        uint64_t expected;
+        std::string expr;
+    };
+
+    // 联合枚举的结果：product 为 false 时 domain 的笛卡尔积比真正的解集大
+    struct Joint {
+        std::vector<int32_t> bytes;              // 参与联合枚举的字节
+        std::vector<std::vector<uint8_t>> rows;  // 解不超过 16 个时全部列出，每行对应 bytes
+        size_t count = 0;
+        bool product = true;
+    };
+
+private:
+    enum class Kind : uint8_t { Const, Input, Add, Xor, Mul, And, Rol };
+
+    // unknown: -1 表示已知常量，>=0 表示唯一依赖的输入字节，-2 表示依赖多个字节
+    struct Node { Kind kind; int32_t a; int32_t b; uint64_t imm; int32_t unknown; };
+
+    struct Pending { int32_t node; uint64_t expected; };
+
+    std::vector<Node> nodes;
+    std::vector<std::bitset<256>> domain;
+    std::vector<Pending> pending;
+    size_t enum_budget;
+    bool unsat = false;
+    Joint joint;
+
+    // refresh 的备忘录：每固定一个字节 generation 就加一
+    uint32_t generation = 1;
+    std::vector<uint32_t> memo_gen;
+    std::vector<int32_t> memo_id;
+
+    static uint64_t inverse(uint64_t c) {
+        // 奇数模 2^64 的逆元：牛顿迭代，每轮精度翻倍
+        uint64_t x = c;
+        for (int i = 0; i < 5; ++i) x *= 2 - c * x;
+        return x;
+    }
+
+    static uint64_t leaf(uint64_t byte, uint64_t sign_extend) {
+        return sign_extend ? (uint64_t)(int64_t)(int8_t)byte : byte;
+    }
+
+    static uint64_t apply(Kind k, uint64_t a, uint64_t b, uint64_t imm) {
+        switch (k) {
+        case Kind::Add: return a + b;
+        case Kind::Xor: return a ^ b;
+        case Kind::Mul: return a * b;
+        case Kind::And: return a & imm;
+        case Kind::Rol: return std::rotl(a, (int)(imm & 63));
+        default: return a;
+        }
+    }
+
+    int fixed(int32_t byte) const {
+        if (domain[byte].count() != 1) return -1;
+        return lowest(domain[byte]);
+    }
+
+    int32_t make_const(uint64_t v) {
+        nodes.push_back({ Kind::Const, -1, -1, v, -1 });
+        return (int32_t)nodes.size() - 1;
+    }
+
+    int32_t make_input(int32_t byte, uint64_t sign_extend) {
+        if (int v = fixed(byte); v >= 0) return make_const(leaf(v, sign_extend));
+        nodes.push_back({ Kind::Input, byte, -1, sign_extend, byte });
+        return (int32_t)nodes.size() - 1;
+    }
+
+    int32_t make(Kind k, int32_t a, int32_t b, uint64_t imm) {
+        const Node& na = nodes[a];
+        const Node& nb = b >= 0 ? nodes[b] : na;
+        if (na.kind == Kind::Const && nb.kind == Kind::Const)
+            return make_const(apply(k, na.imm, nb.imm, imm));
+
+        // 单位元和零元：x+0、x^0、x*1 就是 x，x*0 是常量，免得无关的字节混进同一条约束
+        if (b >= 0 && (na.kind == Kind::Const || nb.kind == Kind::Const)) {
+            uint64_t c = na.kind == Kind::Const ? na.imm : nb.imm;
+            int32_t other = na.kind == Kind::Const ? b : a;
+            if (k == Kind::Mul && c == 0) return make_const(0);
+            if ((k == Kind::Add || k == Kind::Xor) && c == 0) return other;
+            if (k == Kind::Mul && c == 1) return other;
+        }
+
+        int32_t u = na.unknown;
+        if (u == -1) u = nb.unknown;
+        else if (nb.unknown != -1 && nb.unknown != u) u = -2;
+
+        nodes.push_back({ k, a, b, imm, u });
+        return (int32_t)nodes.size() - 1;
+    }
+
+    // 把已经固定的字节代入表达式，重新折叠常量
+    int32_t refresh(int32_t root) {
+        const Node& r = nodes[root];
+        if (r.kind == Kind::Const) return root;
+        if (r.unknown >= 0 && fixed(r.unknown) < 0) return root;
+
+        if (memo_gen.size() < nodes.size()) {
+            memo_gen.resize(nodes.size(), 0);
+            memo_id.resize(nodes.size(), -1);
+        }
+
+        // 显式栈的后序遍历，10^5 条指令的链也不会爆栈
+        std::vector<std::pair<int32_t, bool>> stack{ { root, false } };
+        while (!stack.empty()) {
+            auto [id, expanded] = stack.back();
+            stack.pop_back();
+            if (memo_gen[id] == generation) continue;
+
+            Node n = nodes[id];
+            bool stale = n.kind != Kind::Const && (n.unknown == -2 || (n.unknown >= 0 && fixed(n.unknown) >= 0));
+            if (!stale) {
+                memo_gen[id] = generation;
+                memo_id[id] = id;
+                continue;
+            }
+            if (n.kind == Kind::Input) {
+                int32_t nid = make_const(leaf(fixed(n.a), n.imm));
+                memo_gen[id] = generation;
+                memo_id[id] = nid;
+                continue;
+            }
+            if (!expanded) {
+                stack.push_back({ id, true });
+                stack.push_back({ n.a, false });
+                if (n.b >= 0) stack.push_back({ n.b, false });
+                continue;
+            }
+            int32_t a = memo_id[n.a];
+            int32_t b = n.b >= 0 ? memo_id[n.b] : -1;
+            int32_t nid = (a == n.a && b == n.b) ? id : make(n.kind, a, b, n.imm);
+            if (memo_gen.size() < nodes.size()) {
+                memo_gen.resize(nodes.size(), 0);
+                memo_id.resize(nodes.size(), -1);
+            }
+            memo_gen[id] = generation;
+            memo_id[id] = nid;
+        }
+        return memo_id[root];
+    }
+
+    // 在单字节 byte 取值 v 时计算子表达式
+    uint64_t evaluate(int32_t root, uint64_t v, std::vector<uint64_t>& scratch, const std::vector<int32_t>& cone) {
+        for (int32_t id : cone) {
+            const Node& n = nodes[id];
+            switch (n.kind) {
+            case Kind::Const: scratch[id] = n.imm; break;
+            case Kind::Input: scratch[id] = leaf(v, n.imm); break;
+            default: scratch[id] = apply(n.kind, scratch[n.a], n.b >= 0 ? scratch[n.b] : 0, n.imm); break;
+            }
+        }
+        return scratch[root];
+    }
+
+    // 收集子表达式的全部节点，按 id 升序即为拓扑序
+    std::vector<int32_t> cone_of(int32_t root) {
+        std::vector<int32_t> cone;
+        std::vector<int32_t> stack{ root };
+        std::vector<bool> seen(nodes.size(), false);
+        while (!stack.empty()) {
+            int32_t id = stack.back();
+            stack.pop_back();
+            if (seen[id]) continue;
+            seen[id] = true;
+            cone.push_back(id);
+            const Node& n = nodes[id];
+            if (n.kind == Kind::Const || n.kind == Kind::Input) continue;
+            stack.push_back(n.a);
+            if (n.b >= 0) stack.push_back(n.b);
+        }
+        std::sort(cone.begin(), cone.end());
+        return cone;
+    }
+
+    // 回退方案：只对无法求逆的那一段子表达式做逐字节枚举
+    std::bitset<256> enumerate(int32_t root, uint64_t target) {
+        int32_t byte = nodes[root].unknown;
+        std::vector<int32_t> cone = cone_of(root);
+        std::vector<uint64_t> scratch(nodes.size());
+        std::bitset<256> hits;
+        for (int v = 0; v < 256; ++v) {
+            if (domain[byte][v] && evaluate(root, v, scratch, cone) == target) hits.set(v);
+        }
+        return hits;
+    }
+
+    // 从断言的期望值出发，沿着唯一的未知路径逐条求逆
+    std::bitset<256> invert(int32_t id, uint64_t target) {
+        while (true) {
+            const Node& n = nodes[id];
+            if (n.kind == Kind::Input) {
+                std::bitset<256> hits;
+                uint64_t v = target & 0xFF;
+                if (leaf(v, n.imm) == target && domain[n.a][v]) hits.set(v);
+                return hits;
+            }
+            if (n.kind == Kind::Rol) {
+                target = std::rotr(target, (int)(n.imm & 63));
+                id = n.a;
+                continue;
+            }
+            // 截断丢掉了高位，没法直接求逆
+            if (n.kind == Kind::And) return enumerate(id, target);
+
+            // 二元运算：必须恰好一侧是常量才能求逆
+            const Node& na = nodes[n.a];
+            const Node& nb = nodes[n.b];
+            if (na.kind != Kind::Const && nb.kind != Kind::Const) return enumerate(id, target);
+            uint64_t c = na.kind == Kind::Const ? na.imm : nb.imm;
+            int32_t open = na.kind == Kind::Const ? n.b : n.a;
+
+            switch (n.kind) {
+            case Kind::Add: target -= c; break;
+            case Kind::Xor: target ^= c; break;
+            case Kind::Mul:
+                if ((c & 1) == 0) return enumerate(id, target);
+                target *= inverse(c);
+                break;
+            default: return enumerate(id, target);
+            }
+            id = open;
+        }
+    }
+
+    void fix(int32_t byte, const std::bitset<256>& hits) {
+        std::bitset<256> next = domain[byte] & hits;
+        if (next.none()) { unsat = true; return; }
+        if (next != domain[byte]) {
+            domain[byte] = next;
+            if (next.count() == 1) ++generation;
+        }
+    }
+
+    // 反复消解待定约束，直到没有新的字节被固定
+    void drain() {
+        bool progress = true;
+        while (progress && !unsat) {
+            progress = false;
+            for (size_t i = 0; i < pending.size() && !unsat;) {
+                Pending& c = pending[i];
+                c.node = refresh(c.node);
+                const Node& n = nodes[c.node];
+                if (n.unknown == -1) {
+                    if (n.imm != c.expected) unsat = true;
+                }
+                else if (n.unknown >= 0) {
+                    uint32_t before = generation;
+                    fix(n.unknown, invert(c.node, c.expected));
+                    progress |= generation != before;
+                }
+                else {
+                    ++i;
+                    continue;
+                }
+                pending[i] = pending.back();
+                pending.pop_back();
+            }
+        }
+    }
+
+    // 一组约束涉及的全部输入字节
+    std::vector<int32_t> inputs_of(std::span<const Pending> cs) {
+        std::vector<int32_t> bytes;
+        std::vector<bool> used(domain.size(), false);
+        for (const auto& c : cs) {
+            for (int32_t id : cone_of(c.node)) {
+                if (nodes[id].kind == Kind::Input && !used[nodes[id].a]) {
+                    used[nodes[id].a] = true;
+                    bytes.push_back(nodes[id].a);
+                }
+            }
+        }
+        std::sort(bytes.begin(), bytes.end());
+        return bytes;
+    }
+
+    // 取值组合数，超出预算时返回 SIZE_MAX
+    size_t space_of(const std::vector<int32_t>& bytes) const {
+        size_t space = 1;
+        for (int32_t b : bytes) {
+            space *= domain[b].count();
+            if (space > enum_budget) return SIZE_MAX;
+        }
+        return space;
+    }
+
+    // 枚举 bytes 的全部取值组合，同时满足 cs 里所有约束时调用 hit(value)
+    template <typename F>
+    void search(const std::vector<int32_t>& bytes, std::span<const Pending> cs, size_t space, F&& hit) {
+        std::vector<std::vector<int32_t>> cones;
+        for (const auto& c : cs) cones.push_back(cone_of(c.node));
+        std::vector<uint64_t> scratch(nodes.size());
+        std::vector<int> value(domain.size(), 0);
+
+        for (size_t k = 0; k < space; ++k) {
+            size_t rest = k;
+            for (int32_t b : bytes) {
+                size_t cnt = domain[b].count();
+                size_t pick = rest % cnt;
+                rest /= cnt;
+                int v = 0;
+                while (!domain[b][v] || pick--) ++v;
+                value[b] = v;
+            }
+            bool ok = true;
+            for (size_t i = 0; i < cs.size() && ok; ++i) {
+                for (int32_t id : cones[i]) {
+                    const Node& n = nodes[id];
+                    switch (n.kind) {
+                    case Kind::Const: scratch[id] = n.imm; break;
+                    case Kind::Input: scratch[id] = leaf(value[n.a], n.imm); break;
+                    default: scratch[id] = apply(n.kind, scratch[n.a], n.b >= 0 ? scratch[n.b] : 0, n.imm); break;
+                    }
+                }
+                ok = scratch[cs[i].node] == cs[i].expected;
+            }
+            if (ok) hit(value);
+        }
+    }
+
+    // 联合枚举超出预算时的退路：每条约束单独枚举它自己的字节，把投影交回各字节的取值范围
+    // 结果是解集的超集，但能单独检验的约束都用上了；字节被固定后再交给 drain() 继续求逆
+    void project_each() {
+        bool progress = true;
+        while (progress && !unsat) {
+            progress = false;
+            for (size_t i = 0; i < pending.size() && !unsat; ++i) {
+                pending[i].node = refresh(pending[i].node);
+                std::span<const Pending> one(&pending[i], 1);
+                std::vector<int32_t> bytes = inputs_of(one);
+                size_t space = space_of(bytes);
+                if (space == SIZE_MAX) continue;
+
+                std::vector<std::bitset<256>> seen(domain.size());
+                search(bytes, one, space, [&](const std::vector<int>& value) {
+                    for (int32_t b : bytes) seen[b].set(value[b]);
+                    });
+                for (int32_t b : bytes) {
+                    auto before = domain[b];
+                    fix(b, seen[b]);
+                    progress |= domain[b] != before;
+                }
+            }
+            if (progress && !unsat) drain();
+        }
+    }
+
+    // 最后仍然纠缠在一起的约束：在预算内对剩余字节做联合枚举
+    // 每个字节的取值范围只是联合解的投影，投影的笛卡尔积比解集大时记下来，解不多就全部列出
+    void joint_enumerate() {
+        constexpr size_t kListMax = 16;
+
+        std::vector<int32_t> bytes = inputs_of(pending);
+        if (space_of(bytes) == SIZE_MAX) {
+            project_each();
+            if (unsat || pending.empty()) return;
+            bytes = inputs_of(pending);
+        }
+        size_t space = space_of(bytes);
+        if (space == SIZE_MAX) return;
+
+        std::vector<std::bitset<256>> seen(domain.size());
+        size_t count = 0;
+        joint.bytes = bytes;
+        joint.rows.clear();
+        search(bytes, pending, space, [&](const std::vector<int>& value) {
+            for (int32_t b : bytes) seen[b].set(value[b]);
+            if (++count <= kListMax) {
+                std::vector<uint8_t> row;
+                for (int32_t b : bytes) row.push_back((uint8_t)value[b]);
+                joint.rows.push_back(std::move(row));
+            }
+            });
+
+        size_t product = 1;
+        for (int32_t b : bytes) {
+            if (seen[b].none()) { unsat = true; return; }
+            domain[b] = seen[b];
+            product *= seen[b].count();
+        }
+        joint.product = count == product;
+        joint.count = count;
+        if (count > kListMax) joint.rows.clear();
+        pending.clear();
+    }
+
+    // 把一条约束写成可读的表达式，太长就只给节点数
+    std::string describe(int32_t root) {
+        constexpr size_t kMaxNodes = 24;
+        constexpr size_t kMaxText = 160;
+        size_t size = cone_of(root).size();
+        std::string brief = "<" + std::to_string(size) + "-node expression>";
+        if (size > kMaxNodes) return brief;
+
+        auto hex = [](uint64_t v) {
+            char buf[24];
+            std::snprintf(buf, sizeof(buf), "0x%llx", (unsigned long long)v);
+            return std::string(buf);
+        };
+        auto text = [&](auto& self, int32_t id) -> std::string {
+            const Node& n = nodes[id];
+            switch (n.kind) {
+            case Kind::Const: return hex(n.imm);
+            case Kind::Input: return (n.imm ? "sx(input[" : "input[") + std::to_string(n.a) + (n.imm ? "])" : "]");
+            case Kind::And: return "(" + self(self, n.a) + " & " + hex(n.imm) + ")";
+            case Kind::Rol: return "rol(" + self(self, n.a) + ", " + std::to_string(n.imm & 63) + ")";
+            default: break;
+            }
+            const char* op = n.kind == Kind::Add ? " + " : n.kind == Kind::Xor ? " ^ " : " * ";
+            return "(" + self(self, n.a) + op + self(self, n.b) + ")";
+        };
+        // 共享的子表达式会被重复展开，展开后太长同样只给节点数
+        std::string t = text(text, root);
+        return t.size() > kMaxText ? brief : t;
+    }
+
+public:
+    struct Result {
+        bool satisfiable;
+        bool complete;                         // 所有约束都已消解（否则超出枚举预算）
+        std::vector<std::bitset<256>> domain;  // 每个输入字节的可行取值
+        Joint joint;
+        std::vector<Residual> residual;
+    };
+
+    explicit Inverter(size_t budget = 1 << 16) : enum_budget(budget) {}
+
+    Result solve(const Program& prog) {
+        nodes.clear();
+        pending.clear();
+        memo_gen.clear();
+        memo_id.clear();
+        unsat = false;
+        generation = 1;
+        joint = {};
+        domain.assign(prog.input_len, std::bitset<256>().set());
+
+        int32_t zero = make_const(0);
+        std::vector<int32_t> regs(prog.reg_count, zero);
+
+        for (const Step& s : prog.steps) {
+            switch (s.kind) {
+            case Step::LoadImm: regs[s.dst] = make_const(s.imm); break;
+            case Step::LoadInput: regs[s.dst] = make_input(s.src, s.imm); break;
+            case Step::Add: regs[s.dst] = make(Kind::Add, regs[s.dst], regs[s.src], 0); break;
+            case Step::Xor: regs[s.dst] = make(Kind::Xor, regs[s.dst], regs[s.src], 0); break;
+            case Step::Mul: regs[s.dst] = make(Kind::Mul, regs[s.dst], regs[s.src], 0); break;
+            case Step::MulImm: regs[s.dst] = make(Kind::Mul, regs[s.dst], make_const(s.imm), 0); break;
+            case Step::AndImm: regs[s.dst] = make(Kind::And, regs[s.dst], -1, s.imm); break;
+            case Step::Rol: regs[s.dst] = make(Kind::Rol, regs[s.dst], -1, s.imm); break;
+            case Step::Assert:
+                pending.push_back({ regs[s.dst], s.imm });
+                drain();
+                // 新固定的字节代入寄存器，避免表达式无限增长
+                for (auto& r : regs) r = refresh(r);
+                break;
+            }
+            if (unsat) break;
+        }
+
+        if (!unsat && !pending.empty()) joint_enumerate();
+
+        std::vector<Residual> residual;
+        if (!unsat) {
+            for (auto& c : pending) {
+                c.node = refresh(c.node);
+                residual.push_back({ inputs_of(std::span<const Pending>(&c, 1)), c.expected, describe(c.node) });
+            }
+        }
+        return { !unsat, !unsat && pending.empty(), domain, joint, std::move(residual) };
+    }
+};
+
+// ==========================================
+// 3. 具体解释器：用于生成期望值和校验解
+// ==========================================
+bool run_concrete(const Program& prog, const std::vector<uint8_t>& key) {
+    std::vector<uint64_t> regs(prog.reg_count, 0);
+    for (const Step& s : prog.steps) {
+        switch (s.kind) {
+        case Step::LoadImm: regs[s.dst] = s.imm; break;
+        case Step::LoadInput: regs[s.dst] = s.imm ? (uint64_t)(int64_t)(int8_t)key[s.src] : key[s.src]; break;
+        case Step::Add: regs[s.dst] += regs[s.src]; break;
+        case Step::Xor: regs[s.dst] ^= regs[s.src]; break;
+        case Step::Mul: regs[s.dst] *= regs[s.src]; break;
+        case Step::MulImm: regs[s.dst] *= s.imm; break;
+        case Step::AndImm: regs[s.dst] &= s.imm; break;
+        case Step::Rol: regs[s.dst] = std::rotl(regs[s.dst], (int)(s.imm & 63)); break;
+        case Step::Assert: if (regs[s.dst] != s.imm) return false; break;
+        }
+    }
+    return true;
+}
+
+// 随机生成一段由可逆运算组成的程序，断言的期望值由随机密钥算出
+Program generate(size_t length, int key_len, uint64_t seed, std::vector<uint8_t>& key) {
+    std::mt19937_64 rng(seed);
+    key.resize(key_len);
+    for (auto& b : key) b = (uint8_t)rng();
+
+    Program p;
+    p.input_len = key_len;
+    std::vector<uint64_t> regs(p.reg_count, 0);
+
+    for (size_t i = 0; i < length; ++i) {
+        Step s{};
+        s.dst = (int)(rng() % p.reg_count);
+        s.src = (int)(rng() % p.reg_count);
+        switch (rng() % 8) {
+        case 0: s.kind = Step::LoadInput; s.src = (int)(rng() % key_len); s.imm = rng() & 1; break;
+        case 1: s.kind = Step::LoadImm; s.imm = rng(); break;
+        case 2: s.kind = Step::Add; break;
+        case 3: s.kind = Step::Xor; break;
+        case 4: s.kind = Step::MulImm; s.imm = rng() | 1; break;
+        case 5: s.kind = Step::Rol; s.imm = rng() % 64; break;
+        case 6: s.kind = Step::Mul; break;
+        default: s.kind = Step::Assert; break;
+        }
+        switch (s.kind) {
+        case Step::LoadImm: regs[s.dst] = s.imm; break;
+        case Step::LoadInput: regs[s.dst] = s.imm ? (uint64_t)(int64_t)(int8_t)key[s.src] : key[s.src]; break;
+        case Step::Add: regs[s.dst] += regs[s.src]; break;
+        case Step::Xor: regs[s.dst] ^= regs[s.src]; break;
+        case Step::Mul: regs[s.dst] *= regs[s.src]; break;
+        case Step::MulImm: regs[s.dst] *= s.imm; break;
+        case Step::AndImm: regs[s.dst] &= s.imm; break;
+        case Step::Rol: regs[s.dst] = std::rotl(regs[s.dst], (int)s.imm); break;
+        case Step::Assert: s.imm = regs[s.dst]; break;
+        }
+        p.steps.push_back(s);
+    }
+    return p;
+}
+
+// ==========================================
+// 4. 输出
+// ==========================================
+void print_residual(const Inverter::Residual& c) {
+    std::cout << "    unresolved over input[";
+    for (size_t i = 0; i < c.bytes.size(); ++i) std::cout << (i ? "," : "") << c.bytes[i];
+    std::cout << "]: " << c.expr << " == 0x" << std::hex << c.expected << std::dec << "\n";
+}
+
+void report(const char* name, const Inverter::Result& r) {
+    std::cout << "[" << name << "] ";
+    if (!r.satisfiable) {
+        std::cout << "UNSAT\n";
+        return;
+    }
+    std::cout << (!r.complete ? "partially solved (enumeration budget exceeded)"
+        : r.joint.product ? "solved" : "solved (bytes are entangled, per-byte values are a projection)") << "\n";
+
+    std::vector<bool> entangled(r.domain.size(), false);
+    for (const auto& c : r.residual)
+        for (int32_t b : c.bytes) entangled[b] = true;
+
+    std::string key;
+    for (size_t i = 0; i < r.domain.size(); ++i) {
+        size_t n = r.domain[i].count();
+        std::cout << "    input[" << i << "]: ";
+        if (n == 1) {
+            int v = (int)lowest(r.domain[i]);
+            std::cout << "0x" << std::hex << v << std::dec;
+            if (v >= 0x20 && v < 0x7F) std::cout << " '" << (char)v << "'";
+            key += (char)v;
+        }
+        else if (n == 256) {
+            std::cout << (entangled[i] ? "entangled, see unresolved constraints" : "unconstrained");
+            key += '?';
+        }
+        else {
+            std::cout << n << " candidates {";
+            for (int v = 0, shown = 0; v < 256 && shown < 8; ++v)
+                if (r.domain[i][v]) std::cout << (shown++ ? ", " : "") << "0x" << std::hex << v << std::dec;
+            std::cout << (n > 8 ? ", ...}" : "}");
+            key += '?';
+        }
+        std::cout << "\n";
+    }
+    for (const auto& c : r.residual) print_residual(c);
+    if (r.joint.product) {
+        std::cout << "    key: " << key << "\n";
+        return;
+    }
+    std::cout << "    " << r.joint.count << " joint solutions over input[";
+    for (size_t i = 0; i < r.joint.bytes.size(); ++i) std::cout << (i ? "," : "") << r.joint.bytes[i];
+    std::cout << "]" << (r.joint.rows.empty() ? " (too many to list)" : ":") << "\n";
+    for (const auto& row : r.joint.rows) {
+        std::cout << "     ";
+        for (uint8_t v : row) std::cout << " 0x" << std::hex << (int)v << std::dec;
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    Inverter solver;
+
+    report("Alpha", solver.solve(lower(Alpha::build_program())));
+    // Beta 的字节码依赖输入长度，正确分支要求长度为 4
+    report("Beta", solver.solve(lower(Beta::build_program(4))));
+
+    // 向量指令的展开：用已知的长 Key 生成向量化校验程序，解出的每个字节都必须是原 Key
+    constexpr std::string_view long_key = "Vector lowering must pin every byte: 0123456789";
+    auto vr = solver.solve(lower(Alpha::build_long_program(long_key, true)));
+    bool vec_ok = vr.satisfiable && vr.domain.size() >= long_key.size();
+    for (size_t i = 0; i < long_key.size() && vec_ok; ++i)
+        vec_ok = vr.domain[i].count() == 1 && lowest(vr.domain[i]) == (uint8_t)long_key[i];
+    std::cout << "[Alpha vector] " << long_key.size() << "-byte key " << (vec_ok ? "recovered" : "NOT RECOVERED") << "\n";
+    if (!vec_ok) return 1;
+
+    // 可选：Solver <指令数> [密钥长度] [种子] 对随机生成的程序做压力测试
+    if (argc < 2) return 0;
+    size_t length = std::strtoull(argv[1], nullptr, 10);
+    int key_len = argc > 2 ? std::atoi(argv[2]) : 64;
+    uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1;
+    if (key_len <= 0) {
+        std::cout << "usage: Solver <length> [key_len > 0] [seed]\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> key;
+    Program prog = generate(length, key_len, seed, key);
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto r = solver.solve(prog);
+    auto t1 = std::chrono::steady_clock::now();
+
+    // 真实密钥必须落在解集内；若解唯一，再用具体解释器复核
+    bool contains = r.satisfiable;
+    bool unique = r.satisfiable;
+    std::vector<uint8_t> solved(key_len);
+    for (int i = 0; i < key_len && contains; ++i) {
+        contains = r.domain[i][key[i]];
+        unique &= r.domain[i].count() == 1;
+        solved[i] = key[i];
+    }
+    if (unique) {
+        for (int i = 0; i < key_len; ++i) solved[i] = (uint8_t)lowest(r.domain[i]);
+    }
+    // 联合解都列出来了，真实密钥必须是其中一行
+    if (contains && !r.joint.rows.empty()) {
+        bool row_hit = false;
+        for (const auto& row : r.joint.rows) {
+            bool same = true;
+            for (size_t j = 0; j < row.size(); ++j) same &= row[j] == key[r.joint.bytes[j]];
+            row_hit |= same;
+        }
+        contains = row_hit;
+    }
+
+    size_t pinned = 0, narrowed = 0;
+    for (const auto& d : r.domain) {
+        pinned += d.count() == 1;
+        narrowed += d.count() > 1 && d.count() < 256;
+    }
+
+    std::cout << "\n[Generated] " << length << " instructions, " << key_len << "-byte key, seed " << seed << "\n";
+    std::cout << "    time: " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+    std::cout << "    bytes pinned: " << pinned << "/" << key_len << ", narrowed: " << narrowed << (r.complete ? "" : " (budget exceeded)") << "\n";
+    if (!r.joint.product) std::cout << "    entangled bytes: " << r.joint.bytes.size() << ", joint solutions: " << r.joint.count << "\n";
+    for (const auto& c : r.residual) print_residual(c);
+    std::cout << "    real key in solution set: " << (contains ? "yes" : "NO") << "\n";
+    if (unique) std::cout << "    replay: " << (run_concrete(prog, solved) ? "pass" : "FAIL") << "\n";
+
+    return contains ? 0 : 1;
+}